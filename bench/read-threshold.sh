@@ -0,0 +1,39 @@
+#!/bin/bash
+#
+# Copyright (C) 2020 Canonical, Ltd.
+#
+# This program is free software; you can redistribute it and/or
+# modify it under the terms of the GNU General Public License
+# as published by the Free Software Foundation; either version 2
+# of the License, or (at your option) any later version.
+#
+# Sweep the kernelscan -r read() vs mmap() size threshold over a
+# source tree and report the best of N runs for each threshold.
+#
+# usage: bench/read-threshold.sh path-to-kernel-source [runs] [kernelscan args]
+#
+KERNELSCAN=${KERNELSCAN:-./kernelscan}
+TREE=$1
+RUNS=${2:-5}
+shift
+[ $# -gt 0 ] && shift
+
+if [ -z "$TREE" ] || [ ! -d "$TREE" ]; then
+	echo "usage: $0 path-to-kernel-source [runs] [kernelscan args]" >&2
+	exit 1
+fi
+
+printf "%10s %10s\n" "threshold" "best (ms)"
+for threshold in 0 4096 8192 16384 32768 65536 131072 262144 524288 1048576; do
+	best=0
+	for run in $(seq "$RUNS"); do
+		start=$(date +%s%N)
+		"$KERNELSCAN" -x -r "$threshold" "$@" "$TREE" > /dev/null
+		end=$(date +%s%N)
+		t=$(((end - start) / 1000000))
+		if [ "$best" -eq 0 ] || [ "$t" -lt "$best" ]; then
+			best=$t
+		fi
+	done
+	printf "%10d %10d\n" "$threshold" "$best"
+done
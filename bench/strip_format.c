@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2020 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * Compare the format DFA strip_format() against the linear scan of
+ * formats[] it replaced. Lines are read from a file, one message per
+ * line such as the output of kernelscan -x, or generated at random.
+ * Both versions must strip every line identically.
+ *
+ * usage: bench/strip_format [messages-file] [rounds]
+ */
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+
+#define SIZEOF_ARRAY(x)		(sizeof(x) / sizeof(x[0]))
+#define RANDOM_LINES		(200000)
+#define LINE_MAX_LEN		(4096)
+
+#include "kernelscan-tables.h"
+#include "kernelscan-formats.h"
+
+/*
+ *  strip_format() before the format DFA
+ */
+static void strip_format_linear(char *line)
+{
+	register char *ptr1 = line, *ptr2 = line;
+
+	while (*ptr1) {
+		if ((*ptr1 == '%') && *(ptr1 + 1)) {
+			register size_t i;
+
+			*ptr2++ = ' ';
+			ptr1++;
+			if (*ptr1 == '-')
+				ptr1++;
+			while (isdigit(*ptr1) || *ptr1 == '.')
+				ptr1++;
+
+			for (i = 0; i < SIZEOF_ARRAY(formats); i++) {
+				register const size_t len = formats[i].len;
+
+				if (!strncmp(formats[i].format, ptr1, len)) {
+					ptr1 += len;
+					break;
+				}
+			}
+		} else {
+			*ptr2++ = *ptr1++;
+		}
+	}
+	*ptr2 = '\0';
+}
+
+/*
+ *  strip_format() as in kernelscan.c
+ */
+static void strip_format_dfa(char *line)
+{
+	register char *ptr1 = line, *ptr2 = line;
+
+	while (*ptr1) {
+		if ((*ptr1 == '%') && *(ptr1 + 1)) {
+			register char *ptr = ++ptr1;
+			register uint32_t state = FORMAT_START;
+
+			*ptr2++ = ' ';
+			for (;;) {
+				state = format_next[state][format_class[(uint8_t)*ptr]];
+				if (!state)
+					break;
+				ptr++;
+				if (format_accept[state])
+					ptr1 = ptr;
+			}
+		} else {
+			*ptr2++ = *ptr1++;
+		}
+	}
+	*ptr2 = '\0';
+}
+
+/*
+ *  Random message with a mix of text, real specifiers with
+ *  flags, widths and precisions, and near miss specifiers
+ */
+static char *random_line(void)
+{
+	static const char junk[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 .-*%:";
+	char buf[LINE_MAX_LEN], *ptr = buf;
+	int i, n = 1 + rand() % 8;
+
+	for (i = 0; i < n; i++) {
+		int j, words = rand() % 6;
+
+		for (j = 0; j < words; j++)
+			ptr += sprintf(ptr, "%s ", (j & 1) ? "device" : "failed");
+		*ptr++ = '%';
+		if (rand() % 4 == 0)
+			*ptr++ = '-';
+		if (rand() % 3 == 0)
+			ptr += sprintf(ptr, "%d", rand() % 20);
+		if (rand() % 4 == 0)
+			ptr += sprintf(ptr, ".%d", rand() % 10);
+		if (rand() % 4) {
+			const format_t *f = &formats[rand() % SIZEOF_ARRAY(formats)];
+
+			/* sometimes cut short to land mid trie */
+			ptr += sprintf(ptr, "%.*s", (int)(f->len - (rand() % 5 == 0)), f->format);
+		}
+		for (j = rand() % 3; j > 0; j--)
+			*ptr++ = junk[rand() % (sizeof(junk) - 1)];
+	}
+	*ptr = '\0';
+
+	return strdup(buf);
+}
+
+static double timestamp(void)
+{
+	struct timespec ts;
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + ((double)ts.tv_nsec / 1000000000.0);
+}
+
+/*
+ *  Time rounds of stripping copies of all the lines
+ */
+static double bench(
+	void (*strip)(char *line),
+	char **lines,
+	char **copies,
+	const size_t *lens,
+	const size_t n,
+	const int rounds)
+{
+	double t, best = 0.0;
+	int r;
+
+	for (r = 0; r < rounds; r++) {
+		size_t i;
+
+		for (i = 0; i < n; i++)
+			memcpy(copies[i], lines[i], lens[i] + 1);
+		t = timestamp();
+		for (i = 0; i < n; i++)
+			strip(copies[i]);
+		t = timestamp() - t;
+		if ((r == 0) || (t < best))
+			best = t;
+	}
+	return best;
+}
+
+int main(int argc, char **argv)
+{
+	char **lines = NULL, **copies, buf[LINE_MAX_LEN], a[LINE_MAX_LEN], b[LINE_MAX_LEN];
+	size_t *lens, i, n = 0, size = 0, bytes = 0, specifiers = 0;
+	const int rounds = (argc > 2) ? atoi(argv[2]) : 10;
+	double t_linear, t_dfa;
+
+	if ((argc > 1) && strcmp(argv[1], "-")) {
+		FILE *fp = fopen(argv[1], "r");
+
+		if (!fp) {
+			fprintf(stderr, "Cannot open %s\n", argv[1]);
+			exit(EXIT_FAILURE);
+		}
+		while (fgets(buf, sizeof(buf), fp)) {
+			if (n == size) {
+				size = size ? size * 2 : 1024;
+				lines = realloc(lines, size * sizeof(*lines));
+				if (!lines)
+					goto oom;
+			}
+			buf[strcspn(buf, "\n")] = '\0';
+			if (!(lines[n++] = strdup(buf)))
+				goto oom;
+		}
+		(void)fclose(fp);
+	} else {
+		srand(42);
+		n = RANDOM_LINES;
+		lines = calloc(n, sizeof(*lines));
+		if (!lines)
+			goto oom;
+		for (i = 0; i < n; i++)
+			if (!(lines[i] = random_line()))
+				goto oom;
+	}
+
+	copies = calloc(n, sizeof(*copies));
+	lens = calloc(n, sizeof(*lens));
+	if (!copies || !lens)
+		goto oom;
+	for (i = 0; i < n; i++) {
+		const char *ptr;
+
+		lens[i] = strlen(lines[i]);
+		bytes += lens[i];
+		for (ptr = lines[i]; (ptr = strchr(ptr, '%')) != NULL; ptr++)
+			specifiers++;
+		if (!(copies[i] = malloc(lens[i] + 1)))
+			goto oom;
+
+		memcpy(a, lines[i], lens[i] + 1);
+		memcpy(b, lines[i], lens[i] + 1);
+		strip_format_linear(a);
+		strip_format_dfa(b);
+		if (strcmp(a, b)) {
+			fprintf(stderr, "Mismatch stripping \"%s\":\n  linear \"%s\"\n  dfa    \"%s\"\n",
+				lines[i], a, b);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	t_linear = bench(strip_format_linear, lines, copies, lens, n, rounds);
+	t_dfa = bench(strip_format_dfa, lines, copies, lens, n, rounds);
+
+	printf("%zu lines, %zu bytes, %zu '%%' characters, best of %d rounds\n",
+		n, bytes, specifiers, rounds);
+	printf("%-8s %10.3f ms %10.2f ns/specifier\n", "linear",
+		t_linear * 1000.0, specifiers ? t_linear * 1e9 / specifiers : 0.0);
+	printf("%-8s %10.3f ms %10.2f ns/specifier (%.2fx)\n", "dfa",
+		t_dfa * 1000.0, specifiers ? t_dfa * 1e9 / specifiers : 0.0,
+		t_dfa > 0.0 ? t_linear / t_dfa : 0.0);
+
+	exit(EXIT_SUCCESS);
+oom:
+	fprintf(stderr, "Out of memory performing an allocation\n");
+	exit(EXIT_FAILURE);
+}
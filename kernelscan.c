@@ -34,13 +34,24 @@
 #include <sys/time.h>
 #include <sys/mman.h>
 #include <sys/wait.h>
+#include <sys/syscall.h>
 #include <fcntl.h>
-#include <mqueue.h>
+#include <getopt.h>
 #include <signal.h>
+#include <sched.h>
+#include <time.h>
 #include <pthread.h>
 #if defined(__linux__)
 #include <linux/types.h>
 #endif
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#if defined(IORING_FEAT_FAST_POLL)
+#define HAVE_IO_URING
+#endif
+#endif
+#endif
 
 #define OPT_ESCAPE_STRIP	0x00000001
 #define OPT_MISSING_NEWLINE	0x00000002
@@ -49,6 +60,13 @@
 #define OPT_FORMAT_STRIP	0x00000010
 #define OPT_CHECK_WORDS		0x00000020
 #define OPT_PARSE_STRINGS	0x00000040
+#define OPT_IO_URING		0x00000080
+#define OPT_CHECK_FORMAT	0x00000100
+#define OPT_DMESG		0x00000200
+#define OPT_POSITION		0x00000400
+
+#define LONG_OPT_COMPILE_DICT	(0x100)	/* --compile-dict, no short option */
+#define LONG_OPT_DICT_BENCHMARK	(0x101)	/* --dict-benchmark, no short option */
 
 #define UNLIKELY(c)		__builtin_expect((c), 0)
 #define LIKELY(c)		__builtin_expect((c), 1)
@@ -62,17 +80,45 @@
 #define PARSER_CONTINUE		(512)
 
 #define TOKEN_CHUNK_SIZE	(32768)
-#define TABLE_SIZE		(4*16384)
-#define HASH_MASK		(TABLE_SIZE - 1)
 
 #define MAX_WORD_NODES		(27)	/* a..z -> 0..25 and _/0..9 as 26 */
-#define WORD_NODES_HEAP_SIZE	(250000)
-#define PRINTK_NODES_HEAP_SIZE	(12000)
+#define DAWG_EOW		(0x80000000U)	/* DAWG node is the end of a word */
+#define DAWG_LABELS		((1U << MAX_WORD_NODES) - 1)	/* DAWG node edge labels */
+#define DICT_LANES		(8)	/* words walked through the DAWG in lockstep */
+#define SPELLING_GROUP		(16)	/* control bytes probed at once */
+#define SPELLING_TABLE_SIZE	(1024)	/* initial bad spelling slots, power of 2 */
+#define SPELLING_EMPTY		(0x80)	/* control byte of an empty slot */
+#define WORD_SET_SIZE		(4096)	/* initial unique word slots, power of 2 */
+#define ARENA_BLOCK_SIZE	(64 * 1024)	/* arena block size */
+#define ARENA_LARGE		(ARENA_BLOCK_SIZE / 4)	/* bigger allocations get a block */
+#define DICT_LANES_CACHE_SIZE	(1024 * 1024)	/* L2 size if sysconf can't tell */
+#define DAWG_HOT_NODES		(1024)	/* DAWG nodes laid out breadth first */
+#define DAWG_HUGE_PAGE_SIZE	(2 * 1024 * 1024)	/* DAWG is aligned for a THP */
+#define DICT_IMAGE_MAGIC	"KSDAWG\n"	/* 8 bytes including the '\0' */
+#define DICT_IMAGE_VERSION	(1)	/* bump on DAWG layout or mapping changes */
+#define DICT_IMAGE_ENDIAN	(0x01020304U)	/* reads back swapped on the wrong endian */
 #define SIZEOF_ARRAY(x)		(sizeof(x) / sizeof(x[0]))
 
-#define BAD_MAPPING		(0xff)
-
-//#define PACKED_INDEX		(0)
+#define SCAN_BLOCK_SIZE		(64)
+
+#define RING_SIZE		(1024)	/* file hand-off ring slots, power of 2 */
+#define RING_MASK		(RING_SIZE - 1)
+#define RING_BATCH		(8)	/* max files moved per ring operation */
+#define DEQUE_SIZE		(16)	/* per worker deque slots, power of 2 >= RING_BATCH */
+#define DEQUE_MASK		(DEQUE_SIZE - 1)
+#define LARGE_FILE_SIZE		(1024 * 1024)	/* files this size get parsed first */
+#define DIRENTS_SIZE		(32768)	/* getdents64 buffer size */
+#define POOL_BUFFER_SIZE	(64 * 1024)	/* size of pooled file buffers */
+#define POOL_BUFFERS		(1024)	/* max number of pooled file buffers */
+#define READ_THRESHOLD		(64 * 1024)	/* files up to this size are read, not mmap'd */
+#define URING_DEPTH		(64)	/* files in flight per io_uring walker */
+#define URING_ENTRIES		(URING_DEPTH * 4)
+#define URING_CLOSE		(~(uint64_t)0)	/* user_data of fire and forget closes */
+#define DMESG_FORMATS_SIZE	(1024)	/* initial formats per worker */
+#define DMESG_FRAGMENT_MIN	(4)	/* shorter literal text can't be indexed */
+#define DMESG_FRAGMENT_MAX	(32)	/* indexed prefix of the longest literal */
+#define DMESG_NONE		(~(uint32_t)0)	/* no node or matcher */
+#define DMESG_ROOT		(0)	/* automaton root node */
 
 #define _VER_(major, minor, patchlevel)			\
 	((major * 10000) + (minor * 100) + patchlevel)
@@ -124,6 +170,22 @@
 #define ALIGNED(a)	__attribute__((aligned(a)))
 #endif
 
+#if defined(__GNUC__) && NEED_GNUC(3,1,0)
+#define ALWAYS_INLINE	__attribute__((always_inline))
+#else
+#define ALWAYS_INLINE
+#endif
+
+/* x86 SSE2 and AVX2 structural indexing, selected at run time */
+#if defined(__GNUC__) && NEED_GNUC(4,9,0) && \
+    (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HAVE_SCAN_X86
+#define TARGET_SSE2	__attribute__((target("sse2")))
+#define TARGET_AVX2	__attribute__((target("avx2")))
+#define TARGET_POPCNT	__attribute__((target("popcnt")))
+#endif
+
 /* GCC5.0+ target_clones attribute */
 #if defined(__GNUC__) && NEED_GNUC(5,5,0) && STRESS_X86 && \
     !defined(__gnu_hurd__) && !defined(__FreeBSD_Kernel__)
@@ -140,6 +202,7 @@
 
 static const char dictionary[] = "/usr/share/dict/american-english";
 static const char *dictionary_path = dictionary;
+static const char *dmesg_path;
 
 /*
  *  Subset of tokens that we need to intelligently parse the kernel C source
@@ -168,33 +231,57 @@ typedef enum {
  */
 typedef struct {
 	char *ptr;		/* Current end of the token during the lexical analysis */
-	char *token;		/* The gathered string for this token */
-	char *token_end;	/* end of the token */
+	char *token;		/* The token text, in buf or a view of the input */
+	char *token_end;	/* end of buf, or the start of a view */
+	char *buf;		/* The token buffer for gathered strings */
 	size_t len;		/* Length of the token buffer */
 	token_type_t type;	/* The type of token we think it is */
 } token_t;
 
-typedef void (*parse_func_t)(
-        const char *RESTRICT path,
-        unsigned char *RESTRICT data,
-        unsigned char *RESTRICT data_end,
-        token_t *RESTRICT t,
-        token_t *RESTRICT line,
-        token_t *RESTRICT str);
-
 typedef uint16_t get_char_t;
 
+/*
+ *  Structural index of a SCAN_BLOCK_SIZE block of input,
+ *  bit n of each mask is set if byte n is in that class
+ */
 typedef struct {
-	void		*data;
-	size_t		size;
-	parse_func_t	parse_func;
-	char		filename[PATH_MAX];
-} msg_t;
+	uint64_t identifier;
+	uint64_t quote;
+	uint64_t apostrophe;
+	uint64_t slash;
+	uint64_t star;
+	uint64_t hash;
+	uint64_t newline;
+	uint64_t backslash;
+	uint64_t brace_opened;
+	uint64_t brace_closed;
+	uint64_t semicolon;
+} scan_block_t;
+
+/*
+ *  Function scope, tracked by { nesting
+ */
+typedef struct {
+	const unsigned char *data;	/* start of the data */
+	const unsigned char *name;	/* last function like name at file scope */
+	const unsigned char *function;	/* function being defined, NULL outside */
+	uint32_t name_len;		/* length of name */
+	uint32_t function_len;		/* length of function */
+	uint32_t depth;			/* { nesting */
+} scope_t;
 
+/*
+ *  Offsets of the newlines in the file being parsed, filled in
+ *  on the first lookup as most files need no line numbers
+ */
 typedef struct {
-	char *path;
-	mqd_t mq;
-} context_t;
+	const unsigned char *data;	/* start of the file */
+	const unsigned char *data_end;	/* end of the file */
+	uint32_t *offsets;		/* offset of each newline */
+	uint32_t newlines;		/* newlines in the file */
+	uint32_t size;			/* offsets allocated */
+	bool built;			/* offsets are filled in */
+} newline_index_t;
 
 /*
  *  Parser context
@@ -204,2385 +291,481 @@ typedef struct {
 	unsigned char *data;		/* The start data being parsed */
 	unsigned char *data_end;	/* end of the data */
 	bool skip_white_space;		/* Magic skip white space flag */
+	scope_t scope;			/* function being parsed */
 } parser_t;
 
 /*
- *  Hash table entry (linked list of tokens)
+ *  Arena memory block
  */
-typedef struct hash_entry {
-	struct hash_entry *next;
-	char token[0];
-} hash_entry_t;
+typedef struct arena_block {
+	struct arena_block *next;	/* next older block */
+	size_t size;			/* size of data */
+	size_t used;			/* bytes of data allocated */
+	char data[0];
+} arena_block_t;
 
-typedef get_char_t (*get_token_action_t)(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch);
+/*
+ *  Bump allocator for storage that lasts the whole run, each
+ *  thread has its own so no locking is needed and everything
+ *  is released in one go by arena_free() at exit
+ */
+typedef struct {
+	arena_block_t *blocks;	/* blocks, the one being used first */
+	uint64_t allocs;	/* allocations */
+	uint64_t bytes;		/* bytes allocated */
+	uint64_t nblocks;	/* blocks malloc'd */
+	uint64_t block_bytes;	/* bytes of blocks malloc'd */
+} arena_t;
 
 /*
- *  printk format string table items
+ *  Unique word seen by a worker and how often it was seen
  */
 typedef struct {
-	char *format;	/* printk format string */
-	size_t len;	/* length of format string */
-} format_t;
+	const char *word;	/* '\0' terminated word, NULL for an empty slot */
+	uint32_t len;		/* length of word */
+	uint32_t hash;		/* hash of word */
+	uint32_t count;		/* occurrences of word */
+} word_count_t;
 
-#if defined PACKED_INDEX
+/*
+ *  Open addressed set of the unique words a worker has seen,
+ *  so each one only needs looking up in the dictionary once
+ */
 typedef struct {
-	uint8_t	 hi8;
-	uint16_t lo16;
-} PACKED index_t;
-#else
+	word_count_t *slots;	/* slots, a power of 2 of them */
+	uint32_t size;		/* number of slots */
+	uint32_t used;		/* slots in use */
+} word_set_t;
+
+/*
+ *  Format string of a message, for mapping log lines back
+ *  to where in the source they were printed
+ */
+typedef struct {
+	const char *path;	/* source file, in a walker's arena */
+	const char *text;	/* unescaped format, in a worker's arena */
+	uint32_t len;		/* length of text */
+	uint32_t lineno;	/* line of the printk like call */
+} dmesg_format_t;
+
+typedef struct {
+	dmesg_format_t *formats;	/* formats found */
+	uint32_t used;			/* formats used */
+	uint32_t size;			/* formats allocated */
+} dmesg_formats_t;
+
+/*
+ *  Step of a format matcher, specifiers are typed wildcards
+ */
+typedef enum {
+	DMESG_LITERAL,		/* literal text */
+	DMESG_SIGNED,		/* %d %i */
+	DMESG_UNSIGNED,		/* %u */
+	DMESG_HEX,		/* %x %X */
+	DMESG_OCTAL,		/* %o */
+	DMESG_CHAR,		/* %c */
+	DMESG_ANY,		/* %s %p, any run of characters */
+} dmesg_op_type_t;
+
+typedef struct {
+	const char *str;	/* literal text */
+	uint32_t len;		/* length of literal text */
+	dmesg_op_type_t type;	/* what the step matches */
+} dmesg_op_t;
+
+/*
+ *  Matcher for one line of a format, matchers with the same
+ *  indexed fragment are chained from the automaton node the
+ *  fragment ends at
+ */
+typedef struct {
+	uint32_t format;	/* index into the formats */
+	uint32_t op;		/* first step */
+	uint32_t n_ops;		/* number of steps */
+	uint32_t next;		/* next matcher with the same fragment */
+	uint32_t fragment_op;	/* step the fragment starts */
+	const char *fragment;	/* longest literal text, indexed */
+	uint32_t fragment_len;	/* indexed length of fragment */
+	bool anchored;		/* must match up to the end of the line */
+} dmesg_matcher_t;
+
+/*
+ *  Aho-Corasick automaton node, the children of a node are
+ *  consecutive nodes so just their labels need storing
+ */
+typedef struct {
+	uint32_t fail;		/* node of the longest proper suffix */
+	uint32_t output;	/* nearest node on the fail chain with matchers */
+	uint32_t matchers;	/* first matcher whose fragment ends here */
+	uint32_t children;	/* first child node */
+	uint32_t n_children;	/* number of children */
+	uint8_t label;		/* character on the edge into this node */
+} dmesg_node_t;
+
+/*
+ *  Bad spelling, the word is '\0' terminated
+ */
+typedef struct {
+	const char *word;	/* word, in the finding worker's arena */
+	uint32_t len;		/* length of word */
+	uint32_t hash;		/* word_hash() of word */
+} spelling_t;
+
+/*
+ *  Open addressed table of bad spellings, Swiss table style,
+ *  each slot has a control byte holding the low 7 bits of its
+ *  hash or SPELLING_EMPTY and the control bytes are matched a
+ *  group at a time. The first group of control bytes is copied
+ *  past the end so a group can be loaded at any slot
+ */
+typedef struct {
+	uint8_t *ctrl;		/* size + SPELLING_GROUP control bytes */
+	spelling_t *slots;	/* slots, a power of 2 of them */
+	uint32_t size;		/* number of slots */
+	uint32_t used;		/* slots in use */
+} spelling_table_t;
+
+/*
+ *  How a file's contents are held in memory
+ */
+typedef enum {
+	MSG_MMAP,			/* mmap'd */
+	MSG_POOL,			/* read into a pooled buffer */
+	MSG_HEAP,			/* read into a malloc'd buffer */
+} msg_type_t;
+
+/*
+ *  A file handed from the reader to the workers
+ */
 typedef struct {
-	uint32_t lo32;
-} index_t;
+	void		*data;		/* file contents */
+	size_t		size;		/* size of the file */
+	char		*filename;	/* path, in a walker's arena */
+	msg_type_t	type;		/* how data is to be released */
+} msg_t;
+
+/*
+ *  Work-stealing deque of files, the owning worker pushes and
+ *  takes at the bottom, other workers steal from the top
+ */
+typedef struct {
+	int64_t		top ALIGNED(64);	/* next slot to steal */
+	int64_t		bottom ALIGNED(64);	/* next slot to push */
+	msg_t		msgs[DEQUE_SIZE] ALIGNED(64);
+} deque_t;
+
+/*
+ *  Per parser thread state, each worker owns its own
+ *  tokens and statistics and these get merged at the end
+ */
+typedef struct {
+	deque_t deque;			/* files queued for this worker */
+	token_t t;			/* token being lexed */
+	token_t line;			/* joined kernel message */
+	token_t str;			/* gathered literal strings */
+	token_t format;			/* gathered format string */
+	token_t out;			/* output for the current file */
+	uint32_t finds;			/* print statements found */
+	uint32_t format_mismatches;	/* formats not matching their arguments */
+	uint32_t lines;			/* lines scanned */
+	uint32_t bad_spellings;		/* unique bad spellings */
+	uint32_t bad_spellings_total;	/* all bad spellings */
+	spelling_table_t *spellings;	/* bad spellings found */
+	word_set_t words;		/* unique words to spell check */
+	dmesg_formats_t dmesg;		/* formats for -m */
+	newline_index_t newlines;	/* newlines of the current file */
+	arena_t arena;			/* words */
+	uint32_t id;			/* index into workers[] */
+	pthread_t pthread;		/* worker thread */
+} worker_t;
+
+typedef void (*parse_func_t)(
+	worker_t *RESTRICT w,
+	const char *RESTRICT path,
+	unsigned char *RESTRICT data,
+	unsigned char *RESTRICT data_end);
+
+/*
+ *  File hand-off ring slot, seq tells whether the slot is
+ *  free for the producer or filled and ready for a consumer
+ */
+typedef struct {
+	uint64_t	seq;
+	msg_t		msg;
+} ring_slot_t;
+
+/*
+ *  Bounded lock-free MPMC ring of files to be parsed
+ */
+typedef struct {
+	uint64_t	head ALIGNED(64);	/* next slot to dequeue */
+	uint64_t	tail ALIGNED(64);	/* next slot to enqueue */
+	bool		done ALIGNED(64);	/* no more files will be queued */
+	ring_slot_t	slots[RING_SIZE] ALIGNED(64);
+} ring_t;
+
+/*
+ *  Walker context, files are batched up before being
+ *  pushed onto the ring, large files skip the queue
+ */
+typedef struct {
+	struct uring *uring;		/* io_uring, NULL if not used */
+	uint32_t files;			/* source files found */
+	uint64_t bytes_total;		/* bytes of source mapped */
+	size_t batched;			/* files in batch */
+	msg_t batch[RING_BATCH];	/* files waiting to be queued */
+	char filepath[PATH_MAX];	/* path of entry being walked */
+	char **dirents;			/* getdents64 buffer per depth */
+	uint32_t depth;			/* depth of directory being walked */
+	uint32_t max_depth;		/* depths with a dirents buffer */
+	arena_t arena;			/* paths */
+	pthread_t pthread;		/* walker thread */
+} context_t;
+
+/*
+ *  Directory handed from a busy walker to an idle one
+ */
+typedef struct {
+	int fd;				/* open directory */
+	size_t pathlen;			/* length of path */
+	char *path;			/* path, in a walker's arena */
+} walk_dir_t;
+
+/*
+ *  Pool of directory walker threads
+ */
+typedef struct {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	walk_dir_t *dirs;		/* directories waiting to be walked */
+	uint32_t queued;		/* number of directories in dirs */
+	uint32_t idle;			/* walkers waiting for a directory */
+	uint32_t busy;			/* walkers walking a directory */
+} walk_pool_t;
+
+/*
+ *  Fixed size file buffers recycled between the readers and workers
+ */
+typedef struct {
+	pthread_mutex_t lock;
+	uint32_t nfree;			/* buffers on the free stack */
+	uint32_t allocated;		/* buffers allocated so far */
+	void *free[POOL_BUFFERS];	/* free stack */
+} buffer_pool_t;
+
+#if defined(HAVE_IO_URING)
+typedef enum {
+	URING_OPEN,			/* waiting for openat */
+	URING_STATX,			/* waiting for statx */
+	URING_READ,			/* waiting for read */
+} uring_state_t;
+
+/*
+ *  A file being read through io_uring
+ */
+typedef struct {
+	msg_t msg;			/* file being read */
+	struct statx stx;		/* statx result */
+	size_t done;			/* bytes read so far */
+	int fd;				/* open file, -1 if not open */
+	uring_state_t state;		/* operation in flight */
+} uring_req_t;
+
+/*
+ *  Per walker io_uring
+ */
+typedef struct uring {
+	int fd;				/* io_uring fd */
+	uint32_t *sq_head;		/* shared submission queue head */
+	uint32_t *sq_tail;		/* shared submission queue tail */
+	uint32_t *sq_array;		/* submission queue sqe indices */
+	uint32_t *cq_head;		/* shared completion queue head */
+	uint32_t *cq_tail;		/* shared completion queue tail */
+	uint32_t sq_mask;
+	uint32_t sq_entries;
+	uint32_t cq_mask;
+	uint32_t sqe_tail;		/* local submission queue tail */
+	uint32_t to_submit;		/* sqes not yet submitted */
+	uint32_t in_flight;		/* operations not yet completed */
+	struct io_uring_sqe *sqes;
+	struct io_uring_cqe *cqes;
+	void *sq_ptr;			/* mmap'd rings */
+	void *cq_ptr;
+	size_t sq_len;
+	size_t cq_len;
+	size_t sqes_len;
+	uint32_t nfree;			/* requests on free stack */
+	uint16_t free_reqs[URING_DEPTH];
+	uring_req_t reqs[URING_DEPTH];
+} uring_t;
 #endif
 
-typedef struct word_node {
-	index_t		word_node_index[MAX_WORD_NODES];
-	bool		eow;	/* End of Word flag */
-} PACKED word_node_t ;
+/*
+ *  getdents64() directory entry
+ */
+typedef struct {
+	uint64_t d_ino;
+	int64_t d_off;
+	unsigned short d_reclen;
+	unsigned char d_type;
+	char d_name[];
+} linux_dirent64_t;
+
+typedef get_char_t (*get_token_action_t)(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch);
+
+/*
+ *  dictionary word as mapped characters, used to sort
+ *  the words before they are added to the DAWG
+ */
+typedef struct {
+	const uint8_t *word;	/* mapped characters */
+	uint32_t len;		/* number of mapped characters */
+} dawg_word_t;
+
+/*
+ *  DAWG node, edges are stored in label order so the edge
+ *  for label n is the number of labels below n from the
+ *  first edge
+ */
+typedef struct {
+	uint32_t labels;	/* DAWG_EOW | bitmap of edge labels */
+	uint32_t edge;		/* index of first edge */
+} dawg_node_t;
+
+/*
+ *  Dictionary lookup in flight, each lane walks one word through
+ *  the DAWG alternating between a node and the edge out of it
+ */
+typedef struct {
+	const char *start;	/* start of the word */
+	const char *word;	/* next char of the word */
+	const char *end;	/* end of the word */
+	uint32_t count;		/* occurrences of the word */
+	uint32_t hash;		/* word_hash() of the word */
+	uint32_t index;		/* node index, or edge index if edge is set */
+	bool edge;		/* index is an edge index */
+} dict_lane_t;
+
+/*
+ *  Precompiled dictionary image header, the DAWG nodes follow
+ *  the header and the edges follow the nodes. Nodes and edges
+ *  only refer to each other by index so the image can be
+ *  mapped read-only at any address and used in place
+ */
+typedef struct {
+	char magic[8];		/* DICT_IMAGE_MAGIC */
+	uint32_t version;	/* DICT_IMAGE_VERSION */
+	uint32_t endian;	/* DICT_IMAGE_ENDIAN in native byte order */
+	uint32_t words;		/* words in the source word list */
+	uint32_t dict_size;	/* chars in the source word list */
+	uint32_t root;		/* root node */
+	uint32_t n_nodes;	/* number of nodes */
+	uint32_t n_edges;	/* number of edges */
+	uint32_t reserved;	/* zero, keeps the nodes 8 byte aligned */
+} dict_image_t;
+
+/*
+ *  DAWG state that is still being built, edges are added
+ *  in label order and the last edge's target is filled in
+ *  once the state it leads to is frozen
+ */
+typedef struct {
+	uint32_t labels;			/* DAWG_EOW | bitmap of edge labels */
+	uint32_t n_edges;			/* number of edges */
+	uint32_t targets[MAX_WORD_NODES];	/* edge target nodes */
+} dawg_state_t;
+
+/*
+ *  DAWG builder, frozen states are emitted into growing
+ *  node and edge arrays and registered in an open addressed
+ *  hash so that identical suffixes share the same node
+ */
+typedef struct {
+	dawg_node_t *nodes;	/* emitted nodes */
+	uint32_t *edges;	/* edge target nodes */
+	uint32_t *hash;		/* node + 1, 0 for an empty slot */
+	uint32_t n_nodes;	/* nodes emitted */
+	uint32_t n_edges;	/* edges emitted */
+	uint32_t nodes_size;	/* nodes allocated */
+	uint32_t edges_size;	/* edges allocated */
+	uint32_t hash_size;	/* hash slots, power of 2 */
+} dawg_builder_t;
 
 static uint64_t bytes_total;
 static uint32_t finds;
 static uint32_t files;
 static uint32_t lines;
-static uint32_t lineno;
 static uint32_t bad_spellings;
 static uint32_t bad_spellings_total;
+static uint32_t format_mismatches;
+static uint32_t dmesg_indexed;
+static uint32_t dmesg_unindexed;
+static uint32_t dmesg_nodes_used;
+static uint32_t dmesg_lines;
+static uint32_t dmesg_lines_matched;
+static arena_t arena_totals;
 static uint32_t words;
 static uint32_t dict_size;
 
-static uint8_t opt_flags = OPT_SOURCE_NAME;
+static uint32_t jobs = 1;
+static uint32_t walkers = 1;
+static size_t read_threshold = READ_THRESHOLD;
+static ring_t ring;
+static ring_t ring_large;
+static parse_func_t parse_func;
+
+static uint16_t opt_flags = OPT_SOURCE_NAME;
 static void (*token_cat)(token_t *RESTRICT token, token_t *RESTRICT token_to_add);
 static char quotes[] = "\"";
 static char space[] = " ";
-static bool is_not_whitespace[256] ALIGNED(64);
-static bool is_not_identifier[256] ALIGNED(64);
-
-/*
- *  flat tree of dictionary words
- */
-static word_node_t word_node_heap[WORD_NODES_HEAP_SIZE];
-static word_node_t *word_nodes = &word_node_heap[0];
-static word_node_t *word_node_heap_next = &word_node_heap[1];
-
-/*
- *  flat tree of printk like function names
- */
-static word_node_t printk_node_heap[PRINTK_NODES_HEAP_SIZE];
-static word_node_t *printk_nodes = &printk_node_heap[0];
-static word_node_t *printk_node_heap_next = &printk_node_heap[1];
-
-/*
- *  hash table of bad spellings
- */
-static hash_entry_t *hash_bad_spellings[TABLE_SIZE];
-
-/*
- *  Kernel printk format specifiers
- */
-static format_t formats[] ALIGNED(64) = {
-	{ "%", 1 },
-	{ "s", 1 },
-	{ "llu", 3 },
-	{ "lld", 3 },
-	{ "llx", 3 },
-	{ "llX", 3 },
-	{ "lu", 2 },
-	{ "ld", 2 },
-	{ "lx", 2 },
-	{ "lX", 2 },
-	{ "u", 1 },
-	{ "d", 1 },
-	{ "x", 1 },
-	{ "X", 1 },
-	{ "pF", 2 },
-	{ "pf", 2 },
-	{ "ps", 2 },
-	{ "pSR", 3 },
-	{ "pS", 2 },
-	{ "pB", 2 },
-	{ "pK", 2 },
-	{ "pr", 2 },
-	{ "pap", 3 },
-	{ "pa", 2 },
-	{ "pad", 3 },
-	{ "*pE", 3 },
-	{ "*pEa", 4 },
-	{ "*pEc", 4 },
-	{ "*pEh", 4 },
-	{ "*pEn", 4 },
-	{ "*pEo", 4 },
-	{ "*pEp", 4 },
-	{ "*pEs", 4 },
-	{ "*ph", 3 },
-	{ "*phC", 4 },
-	{ "*phD", 4 },
-	{ "*phN", 4 },
-	{ "pM", 2 },
-	{ "pMR", 3 },
-	{ "pMF", 3 },
-	{ "pm", 2 },
-	{ "pmR", 3 },
-	{ "pi4", 3 },
-	{ "pI4", 3 },
-	{ "pi4h", 4 },
-	{ "pI4h", 4 },
-	{ "pi4n", 4 },
-	{ "pI4n", 4 },
-	{ "pi4b", 4 },
-	{ "pI4b", 4 },
-	{ "pi4l", 4 },
-	{ "pI4l", 4 },
-	{ "pi6", 3 },
-	{ "pI6", 3 },
-	{ "pI6c", 4 },
-	{ "piS", 3 },
-	{ "pIS", 3 },
-	{ "piSc", 4 },
-	{ "pISc", 4 },
-	{ "piSpc", 5 },
-	{ "pISpc", 5 },
-	{ "piSf", 4 },
-	{ "pISf", 4 },
-	{ "piSs", 4 },
-	{ "pISs", 4 },
-	{ "piSh", 4 },
-	{ "pISh", 4 },
-	{ "piSn", 4 },
-	{ "pISn", 4 },
-	{ "piSb", 4 },
-	{ "pISb", 4 },
-	{ "piSl", 4 },
-	{ "pISl", 4 },
-	{ "pUb", 3 },
-	{ "pUB", 3 },
-	{ "pUl", 3 },
-	{ "pUL", 3 },
-	{ "pd", 2 },
-	{ "pd2", 3 },
-	{ "pd3", 3 },
-	{ "pd4", 3 },
-	{ "pD", 2 },
-	{ "pD2", 3 },
-	{ "pD3", 3 },
-	{ "pD4", 3 },
-	{ "pg", 2 },
-	{ "pV", 2 },
-	{ "pC", 2 },
-	{ "pCn", 3 },
-	{ "pCr", 3 },
-	{ "*pb", 3 },
-	{ "*pbl", 4 },
-	{ "pGp", 3 },
-	{ "pGg", 3 },
-	{ "pGv", 3 },
-	{ "pNF", 3 },
-};
+static void (*scan_classify)(const unsigned char *RESTRICT ptr, scan_block_t *RESTRICT b);
+static uint32_t (*count_newlines)(const unsigned char *RESTRICT ptr, const unsigned char *RESTRICT end);
+static void (*index_newlines)(const unsigned char *RESTRICT ptr, const unsigned char *RESTRICT end,
+	uint32_t *RESTRICT offsets);
+static bool (*dict_find_word)(const char *RESTRICT word, size_t len);
+static void (*check_unique_words)(worker_t *RESTRICT w);
 
 /*
- *  various printk like functions to populate the
- *  hash_printks hash table
- */
-static char *printks[] = {
-	"AA_BUG",
-	"AA_DEBUG",
-	"AA_ERROR",
-	"aa_info_message",
-	"ABIT_UGURU3_DEBUG",
-	"ACPI_BIOS_ERROR",
-	"ACPI_BIOS_WARNING",
-	"ACPI_DEBUG_PRINT",
-	"ACPI_DEBUG_PRINT_RAW",
-	"ACPI_ERROR",
-	"ACPI_ERROR_METHOD",
-	"ACPI_EXCEPTION",
-	"ACPI_INFO",
-	"acpi_handle_debug",
-	"acpi_handle_err",
-	"acpi_handle_info",
-	"acpi_handle_warn",
-	"acpi_os_printf",
-	"ACPI_WARNING",
-	"ADBG",
-	"adc_dbg",
-	"adfs_error",
-	"adsp_dbg",
-	"adsp_err",
-	"adv_dbg",
-	"adv_err",
-	"affs_warning",
-	"aha152x_error",
-	"airo_print_dbg",
-	"airo_print_err",
-	"airo_print_info",
-	"airo_print_warn",
-	"amd64_err",
-	"amd64_info",
-	"amd64_notice",
-	"amd64_warn",
-	"apic_debug",
-	"apic_printk",
-	"apm_error",
-	"APRINTK",
-	"aq_pr_err",
-	"ar5523_dbg",
-	"ar5523_err",
-	"ar5523_info",
-	"arizona_aif_dbg",
-	"arizona_aif_err",
-	"arizona_aif_warn",
-	"arizona_fll_dbg",
-	"arizona_fll_err",
-	"arizona_fll_warn",
-	"arm64_notify_die",
-	"arm_notify_die",
-	"arc_printk",
-	"ASC_DBG",
-	"ASC_PRINT",
-	"ASD_DPRINTK",
-	"asd_printk",
-	"asprintf",
-	"at76_dbg",
-	"ata_dev_dbg",
-	"ata_dev_err",
-	"ata_dev_info",
-	"ata_dev_notice",
-	"ata_dev_printk",
-	"ata_dev_warn",
-	"ata_link_dbg",
-	"ata_link_err",
-	"ata_link_info",
-	"ata_link_notice",
-	"ata_link_printk",
-	"ata_link_warn",
-	"ata_link_warn",
-	"ata_port_dbg",
-	"ata_port_desc",
-	"ata_port_err",
-	"ata_port_info",
-	"ata_port_notice",
-	"ata_port_printk",
-	"ata_port_warn",
-	"ata_dev_warn",
-	"ATH5K_PRINTF",
-	"ath10k_dbg",
-	"ath10k_err",
-	"ath10k_info",
-	"ath10k_warn",
-	"ATH5K_DBG",
-	"ATH5K_DBG_UNLIMIT",
-	"ATH5K_ERR",
-	"ATH5K_INFO",
-	"ATH5K_PRINTF",
-	"ATH5K_PRINTK",
-	"ATH5K_WARN",
-	"ath6kl_dbg",
-	"ath6kl_err",
-	"ath6kl_info",
-	"ath6kl_warn",
-	"ath_dbg",
-	"ath_err",
-	"ath_info",
-	"atm_dbg",
-	"atm_err",
-	"atm_info",
-	"atm_printk",
-	"atm_rldbg",
-	"atm_warn",
-	"au0828_isocdbg",
-	"audio_debug",
-	"audio_error",
-	"audio_info",
-	"audio_warning",
-	"audit_log_config_change",
-	"audit_log_link_denied",
-	"audit_log_lost",
-	"audit_log_rule_change",
-	"audit_panic",
-	"audit_printk",
-	"AUX_DBG",
-	"AUX_ERR",
-	"AUX_TRACE",
-	"b43dbg",
-	"b43err",
-	"b43info",
-	"b43warn",
-	"b43legacydbg",
-	"b43legacyerr",
-	"b43legacyinfo",
-	"b43legacywatn",
-	"batadv_dbg",
-	"batadv_dbg_arp",
-	"batadv_err",
-	"batadv_info",
-	"batadv_warn",
-	"bcma_debug",
-	"bcma_err",
-	"bcma_info",
-	"bcma_warn",
-	"bdebug",
-	"befs_debug",
-	"befs_error",
-	"bit_dbg",
-	"bfq_log",
-	"bfq_log_bfqq",
-	"binder_debug"
-	"binder_user_error",
-	"blogic_announce",
-	"blogic_err",
-	"blogic_info",
-	"blogic_notice",
-	"blogic_warn",
-	"BNX2FC_ELS_DBG",
-	"BNX2FC_HBA_DBG",
-	"BNX2FC_IO_DBG",
-	"BNX2FC_MISC_DBG",
-	"BNX2FC_TGT_DBG",
-	"BNX2X_DEV_INFO",
-	"BNX2X_ERR",
-	"BNX2X_ERROR",
-	"bootx_printf",
-	"brcmf_dbg",
-	"brcmf_dbg_info",
-	"brcmf_dbg_tx",
-	"brcmf_err",
-	"brcmf_info",
-	"brcmf_helper",
-	"brcms_dbg_dma",
-	"brcms_dbg_ht",
-	"brcms_dbg_info",
-	"brcms_dbg_int",
-	"brcms_dbg_mac80211",
-	"brcms_dbg_rx",
-	"brcms_dbg_tx",
-	"brcms_err",
-	"br_debug",
-	"br_err",
-	"br_info",
-	"br_notice",
-	"bsg_dbg",
-	"BTC_PRINT",
-	"BT_DBG",
-	"bt_dev_dbg",
-	"bt_dev_err",
-	"bt_dev_err_ratelimited",
-	"bt_dev_info",
-	"bt_dev_warn",
-	"BTE_PRINTK",
-	"BTE_PRINTKV",
-	"BT_ERR",
-	"BT_ERR_RATELIMITED",
-	"BT_INFO",
-	"BT_WARN",
-	"btrfs_crit",
-	"btrfs_debug",
-	"btrfs_err",
-	"btrfs_err_rl",
-	"btrfs_info",
-	"btrfs_warn",
-	"BUF_PRINT",
-	"buf_printf",
-	"BUGFIX",
-	"BUGON",
-	"BUG_ON",
-	"BUGPRINT",
-	"BUS_DBG",
-	"cache_bug",
-	"cafe_dev_dbg",
-	"cal_dbg",
-	"cal_err",
-	"cal_info",
-	"cam_dbg",
-	"cam_err",
-	"cam_warn",
-	"cat_printf",
-	"ccid2_pr_debug",
-	"ccid3_pr_debug",
-	"cd_dbg",
-	"c_dbg",
-	"CDEBUG",
-	"c_err",
-	"ceph_iod_printf",
-	"CERROR",
-	"cfq_log",
-	"cfq_log_cfqq",
-	"ch7006_dbg",
-	"ch7006_err",
-	"ch7006_info",
-	"chan_dbg",
-	"chan_err",
-	"CH_DBG",
-	"CH_ERR",
-	"CH_WARN",
-	"CHECK",
-	"chip_dbg",
-	"chip_err",
-	"CHSC_LOG",
-	"ci_dbg",
-	"ci_dbg_print",
-	"cifs_dbg",
-	"cl_dbg",
-	"cl_err",
-	"cmm_dbg",
-	"cmp_error",
-	"CNETERR",
-	"cobalt_dbg",
-	"cobalt_err",
-	"cobalt_info",
-	"cobalt_warn",
-	"codec_dbg",
-	"codec_err",
-	"codec_info",
-	"codec_warn",
-	"color_fprintf",
-	"conf_message",
-	"conf_printf",
-	"conf_warning",
-	"con_log",
-	"CONN_DBG",
-	"CONN_ERR",
-	"cont",
-	"core_dbg",
-	"cow_printf",
-	"cpc925_mc_printk",
-	"cpc925_printk",
-	"cpsw_err",
-	"cpsw_info",
-	"cpsw_notice",
-	"CS_DBGOUT",
-	"cs89_dbg",
-	"csio_dbg",
-	"csio_err",
-	"csio_warn",
-	"csio_ln_dbg",
-	"csio_ln_err",
-	"ctcm_pr_debug",
-	"CTCM_PR_DEBUG",
-	"ctrl_dbg",
-	"ctrl_err",
-	"ctrl_info",
-	"ctrl_warn",
-	"ctx_dbg",
-	"ctx_err",
-	"CWARN",
-	"cvmx_dprintf",
-	"CX18_ALSA_ERR",
-	"CX18_ALSA_WARN",
-	"CX18_DEBUG_ALSA_INFO",
-	"CX18_DEBUG_API",
-	"CX18_DEBUG_FILE",
-	"CX18_DEBUG_HI_API",
-	"CX18_DEBUG_HI_DMA",
-	"CX18_DEBUG_HI_FILE",
-	"CX18_DEBUG_HI_IRQ",
-	"CX18_DEBUG_INFO",
-	"CX18_DEBUG_IOCTL",
-	"CX18_DEBUG_WARN",
-	"CX18_ERR",
-	"CX18_INFO",
-	"CX18_WARN",
-	"cx231xx_coredbg",
-	"cx231xx_isocdbg",
-	"cx231xx_videodbg",
-	"CX25821_ERR",
-	"CX25821_INFO",
-	"cx_err",
-	"cx_info",
-	"d40_err",
-	"d2printk",
-	"DAC960_Announce",
-	"DAC960_Critical",
-	"DAC960_Error",
-	"DAC960_Info",
-	"DAC960_Notice",
-	"DAC960_Progress",
-	"DAC960_UserCritical",
-	"DAC960_Warning",
-	"dax_dbg",
-	"dax_err",
-	"DB_CFM"
-	"DB_CFMN"
-	"DB_ECM"
-	"DB_ECMN"
-	"DB_ESS"
-	"DB_ESSN"
-	"DBF_DEV_EVENT",
-	"DBF_ERROR",
-	"DBF_EVENT",
-	"DBF_EVENT",
-	"DBF_EXCEPTION",
-	"dbg",
-	"_DBG",
-	"DBG",
-	"DBG1",
-	"DBG2",
-	"DBG3",
-	"DBG4",
-	"DBG_8192C",
-	"DBG_8712",
-	"DBG_871X",
-	"DBG_871X_LEVEL",
-	"DBG_88E",
-	"DBG_88E_LEVEL",
-	"DBGA",
-	"DBGA2",
-	"DBGBH",
-	"DBGC",
-	"dbg_bld",
-	"dbg_blit",
-	"dbg_budg",
-	"DBG_BYPASS",
-	"DBG_CFG",
-	"DBG_CMD",
-	"dbg_cmt",
-	"DBG_CNT",
-	"DBGDCONT",
-	"dbg_dentlist",
-	"DBG_DEVS",
-	"dbg_dump",
-	"dbg_eba",
-	"DB_GEN",
-	"DBGERR",
-	"DBG_ERR",
-	"dbg_find",
-	"dbg_fmt",
-	"dbg_fragtree",
-	"dbg_fragtree2",
-	"dbg_fsbuild",
-	"DBGFS_DUMP",
-	"DBGFS_DUMP_DI",
-	"DBGFS_PRINT_INT",
-	"DBGFS_PRINT_STR",
-	"DBG_FTL",
-	"dbg_gc",
-	"dbg_gen",
-	"dbg_hid",
-	"dbg_info",
-	"DBGINFO",
-	"DBG_INIT",
-	"dbg_inocache",
-	"dbg_io",
-	"DBG_IRT",
-	"DBGISR",
-	"dbg_jnl",
-	"dbg_jnlk",
-	"dbg_log",
-	"DBG_LOG",
-	"DBG_LOTS",
-	"DBG_LOUD",
-	"DBG_LOW",
-	"dbg_lp",
-	"dbg_memalloc",
-	"dbg_mnt",
-	"dbg_mntk",
-	"DBG_MSG",
-	"dbg_noderef",
-	"DBG_PAT",
-	"DBG_PORT",
-	"dbgp_ehci_status",
-	"dbg_pnp_show_resources",
-	"dbgp_printk",
-	"DBGPR",
-	"dbgprint",
-	"DbgPrint",
-	"DBG_printk",
-	"DBG_PRV1",
-	"dbg_qtd",
-	"dbg_rcvry",
-	"dbg_readinode",
-	"dbg_readinode2",
-	"dbg_reg",
-	"dbg_regs",
-	"DBG_REG",
-	"DbgRegister",
-	"DBG_RES",
-	"DBG_RUN",
-	"DBG_RUN_SG",
-	"DBGS",
-	"dbg_scan",
-	"dbg_summary",
-	"dbg_td",
-	"dbg_tnc",
-	"dbg_tnck",
-	"DBG_TRC",
-	"dbg_verbose",
-	"DBG_VERBOSE",
-	"dbg_wl",
-	"dbg_xattr",
-	"DBMSG",
-	"DBP_SAVE",
-	"DB_PCM",
-	"DB_RMT",
-	"DB_RMTN",
-	"DB_RX",
-	"DB_SMT",
-	"DB_SNMP",
-	"DB_TX",
-	"dbug",
-	"DCCP_BUG",
-	"DCCP_CRIT",
-	"dccp_debug",
-	"dccp_pr_debug",
-	"dccp_pr_debug_cat",
-	"DCCP_WARN",
-	"DC_ERR",
-	"DC_ERROR",
-	"dcprintk",
-	"dctlprintk",
-	"DDB",
-	"dd_dev_dbg",
-	"dd_dev_err",
-	"dd_dev_info",
-	"dd_dev_info_ratelimited",
-	"dd_dev_warn",
-	"ddlprintk",
-	"ddprintk",
-	"ddprintk_cont",
-	"deb",
-	"DEB",
-	"DEB1",
-	"DEB2",
-	"DEB3",
-	"DEB_CAP",
-	"deb_chk",
-	"DEB_D",
-	"DEBC_printk",
-	"deb_data",
-	"deb_decode",
-	"DEB_EE",
-	"deb_eeprom",
-	"deb_err",
-	"deb_fe",
-	"deb_fw",
-	"deb_fwdata",
-	"deb_fw_load",
-	"DEBG",
-	"DEB_G",
-	"deb_getf",
-	"deb_hab",
-	"deb_i2c",
-	"DEB_I2C",
-	"deb_i2c_read",
-	"deb_i2c_write",
-	"deb_info",
-	"DEB_INT",
-	"deb_irq",
-	"deb_mem",
-	"DEBPRINT",
-	"DEBPRINTK",
-	"deb_rc",
-	"deb_rdump",
-	"deb_readreg",
-	"deb_reg",
-	"DEB_S",
-	"deb_setf",
-	"deb_sram",
-	"deb_srch",
-	"deb_ts",
-	"deb_tuner",
-	"_debug",
-	"debug",
-	"DEBUG",
-	"DEBUG2",
-	"DEBUG3",
-	"DEBUG_API",
-	"DEBUG_AUTOCONF",
-	"debug_badness",
-	"DEBUG_bytes",
-	"debug_cclk_get",
-	"DEBUG_DBG",
-	"debug_dcl",
-	"DEBUG_ERR",
-	"_debug_bug_printk",
-	"DEBUG_INFO",
-	"DEBUG_IRQ",
-	"debugl1",
-	"debug_log",
-	"DEBUG_LOG",
-	"DEBUG_MARKER",
-	"debug_msg",
-	"DEBUG_MSG",
-	"debug_name",
-	"DEBUGOUTBUF",
-	"DEBUGP",
-	"debug_pci",
-	"debug_polling",
-	"DEBUG_print",
-	"debug_printf",
-	"debug_print_fifo_channel_state",
-	"debug_print_if_state",
-	"debug_print_isp_state",
-	"debug_print_object",
-	"debug_print_rmap",
-	"debug_print_sp_state",
-	"debug_putstr",
-	"DEBUGREAD",
-	"DEBUG_REQ",
-	"debug_shrink_set",
-	"debug_sprintf_event",
-	"debug_sprintf_exception",
-	"DEBUGTRDMA",
-	"DEBUGTXINT",
-	"debug_timestamp",
-	"DEBUGTXINT",
-	"DEBUG_VAE",
-	"DEBUG_WARN",
-	"DEBUGWRITE",
-	"deb_uxfer",
-	"deb_v8",
-	"DEB_VBI",
-	"deb_xfer",
-	"decrypt_done",
-	"decrypt_fail",
-	"decrypt_interrupt",
-	"D_EEPROM",
-	"DERROR",
-	"dev",
-	"dev_alert",
-	"dev_alert_once",
-	"dev_alert_ratelimited",
-	"dev_crit",
-	"dev_crit_once",
-	"dev_crit_ratelimited",
-	"dev_dbg",
-	"dev_dbgdma",
-	"deb_dbg_f",
-	"deb_dbg_lvl",
-	"deb_dbg_ratelimited",
-	"deb_dbg_stamp",
-	"dev_dbg_once",
-	"dev_emerg",
-	"dev_emerg_once",
-	"dev_emerg_ratelimited",
-	"dev_err",
-	"dev_err_console",
-	"dev_err_once",
-	"dev_err_ratelimited",
-	"dev_info",
-	"dev_info_once",
-	"dev_info_ratelimited",
-	"dev_level_once",
-	"dev_level_ratelimited",
-	"dev_notice",
-	"dev_notice_once",
-	"dev_notice_ratelimited",
-	"dev_printk",
-	"dev_printk_emit",
-	"dev_vprintk_emit",
-	"dev_warn",
-	"dev_warn_once",
-	"dev_warn_ratelimited",
-	"devtprintk",
-	"devtverboseprintk",
-	"dev_vdbg",
-	"dev_warn",
-	"dev_WARN",
-	"dev_warn_once",
-	"dev_WARN_ONCE",
-	"dev_warn_ratelimited",
-	"dewtprintk",
-	"dexitprintk",
-	"dfailprintk",
-	"dfprintk",
-	"dhsprintk",
-	"df_trace",
-	"die",
-	"dio_on",
-	"__die_if_kernel",
-	"die_if_kernel",
-	"die_if_no_fixup",
-	"die_nmi",
-	"dintprintk",
-	"dioprintk",
-	"D_INFO",
-	"DIPRINTK",
-	"D_ISR",
-	"diva_log_info",
-	"D_LED",
-	"dlog",
-	"dlprintk",
-	"dm9000_dbg",
-	"DMCRIT",
-	"DMDEBUG",
-	"DMDEBUG_LIMIT",
-	"DMEMIT",
-	"DMERR",
-	"DMERR_LIMIT",
-	"DMESG",
-	"DMESGE",
-	"dmfprintk",
-	"DMINFO",
-	"DMSG",
-	"DMWARN",
-	"DMWARN_LIMIT",
-	"dmz_dev_debug",
-	"dmz_dev_err",
-	"dn_serial_print",
-	"do_BUG",
-	"doc_dbg",
-	"doc_err",
-	"doc_info",
-	"doc_vdbg",
-	"do_error",
-	"do_trap",
-	"do_warning",
-	"do_warning_event",
-	"dout",
-	"DP",
-	"DP_CONT",
-	"DPC",
-	"DPD",
-	"DPD1",
-	"DP_DEBUG",
-	"DP_ERR",
-	"DP_INFO",
-	"DP_VERBOSE",
-	"DPE",
-	"DPE1",
-	"D_POWER",
-	"dprint",
-	"DPRINT",
-	"DPRINT_CONFIG",
-	"dprintf",
-	"Dprintf",
-	"DPRINTF",
-	"dprintf0",
-	"dprintf1",
-	"dprintf2",
-	"dprintf3",
-	"dprintf4",
-	"dprintf5",
-	"dprintk",
-	"Dprintk",
-	"DPRINTK",
-	"dprintk0",
-	"dprintk1",
-	"dprintk2",
-	"dprintkdbg",
-	"dprintk_cont",
-	"dprintk_i2c",
-	"dprintkl",
-	"dprintk_mmu",
-	"dprintk_pte",
-	"dprintk_rcu",
-	"dprintk_sect_loss",
-	"dprintk_sr",
-	"dprintk_tscheck",
-	"DPRINT_ovfl",
-	"DPRINT_TLA",
-	"DPS",
-	"DPS1",
-	"DPX",
-	"DPX1",
-	"D_QOS",
-	"D_RADIO",
-	"D_RATE",
-	"D_RF_KILL",
-	"drbd_alert",
-	"drbd_dbg",
-	"drbd_emerg",
-	"drbd_err",
-	"drbd_info",
-	"drbd_warn",
-	"dreplyprintk",
-	"DRM_DEBUG",
-	"DRM_DEBUG_ATOMIC",
-	"DRM_DEBUG_DRIVER",
-	"DRM_DEBUG_KMS",
-	"DRM_DEBUG_KMS_RATELIMITED",
-	"DRM_DEBUG_LEASE",
-	"DRM_DEBUG_PRIME",
-	"DRM_DEBUG_VBL",
-	"DRM_DEV_DEBUG_KMS",
-	"DRM_DEV_ERROR",
-	"DRM_ERROR",
-	"DRM_ERROR_RATELIMITED",
-	"DRM_INFO",
-	"DRM_INFO_ONCE",
-	"DRM_NODE",
-	"DRM_NOTE",
-	"DRM_WARN",
-	"drm_rect_debug_print",
-	"drm_printf",
-	"drm_printf_indent",
-	"dsb",
-	"dsasprintk",
-	"dsawideprintk",
-	"dsgprintk",
-	"dsprintk",
-	"D_SCAN",
-	"DSSDBG",
-	"DSSERR",
-	"DSSWARN",
-	"D_STATS",
-	"D_TEMP",
-	"DTN_INFO",
-	"dtmprink",
-	"dtrc",
-	"D_TX",
-	"DTX",
-	"D_TXPOWER",
-	"D_TX_REPLY",
-	"dump_printf",
-	"DUMP_printk",
-	"dump_stack_set_arch_desc",
-	"DUMP_VALUE",
-	"DWC2_TRACE_SCHEDULER",
-	"DWC2_TRACE_SCHEDULER_VB",
-	"D_WEP",
-	"dxtrace",
-	"dynamic_pr_debug",
-	"dynamic_hex_dump",
-	"E",
-	"e752x_printk",
-	"e7xxx_printk",
-	"ea_bdebug",
-	"ea_idebug",
-	"earlier",
-	"early_panic",
-	"early_pgtable_allocfail",
-	"early_platform_driver_probe",
-	"early_platform_driver_register_all",
-	"early_print",
-	"early_printk",
-	"ec_dbg_drv",
-	"ec_dbg_evt",
-	"ec_dbg_raw",
-	"ec_dbg_req",
-	"ec_dbg_stm",
-	"ec_log_drv",
-	"ecryptfs_printk",
-	"edac_dbg",
-	"edac_mc_handle_error",
-	"edac_mc_printk",
-	"edac_printk",
-	"e_dbg",
-	"e_dev_err",
-	"e_dev_info",
-	"e_dev_warn",
-	"e_err",
-	"EE",
-	"efi_printk",
-	"efm32_spi_vdbg",
-	"efm_debug",
-	"ehci_dbg",
-	"ehci_err",
-	"ehci_info",
-	"ehci_node",
-	"ehci_off",
-	"ehci_warn",
-	"ehci_dump",
-	"e_info",
-	"EISA_DBG",
-	"elantech_debug",
-	"em28xx_isocdbg",
-	"em28xx_regdbg",
-	"em28xx_videodbg",
-	"en_dbg",
-	"en_err",
-	"en_info",
-	"en_warn",
-	"ep_dbg",
-	"ep_err",
-	"ep_info",
-	"ep_vdbg",
-	"ep_warn",
-	"EP_INFO",
-	"eprintf",
-	"eprintk",
-	"ep_warn"
-	"err",
-	"ERR",
-	"err_chk",
-	"err_cpu",
-	"err_msg",
-	"ERR_MSG",
-	"error",
-	"ERROR",
-	"ErrorF",
-	"error_putstr",
-	"error_with_pos",
-	"err_printf",
-	"err_printk",
-	"err_puts",
-	"err_str",
-	"err_src",
-	"errx"
-	"esas2r_debug",
-	"esas2r_hdebug",
-	"esas2r_trace",
-	"esas2r_log",
-	"esas2r_log_dev",
-	"es_debug",
-	"esp_dma_log",
-	"esp_log_autosense",
-	"esp_log_cmddone",
-	"esp_log_command",
-	"esp_log_datadone",
-	"esp_log_datastart",
-	"esp_log_disconnect",
-	"esp_log_event",
-	"esp_log_intr",
-	"esp_log_msgin",
-	"esp_log_reconnect",
-	"esp_log_reset",
-	"esw_debug",
-	"esw_info",
-	"esw_warn",
-	"EVENT",
-	"e_warn",
-	"EXCEPTION",
-	"EXOFS_DBGMSG",
-	"EXOFS_DBGMSG2",
-	"EXOFS_ERR",
-	"ext2_debug",
-	"ext2_error",
-	"exy2_msg",
-	"ext4_abort",
-	"ext4_debug",
-	"ext4_error",
-	"ext4_lo_info",
-	"ext4_msg",
-	"ext4_warning",
-	"ext4_warning_inode",
-	"EXT4_ERROR_INODE",
-	"ext_debug",
-	"f2fs_cp_error",
-	"f2fs_msg",
-	"fail",
-	"fail_reason",
-	"FAIL",
-	"fatal",
-	"fatal_perror",
-	"fas216_log",
-	"fas216_log_target",
-	"fatal_perror",
-	"fat_fs_error",
-	"fat_msg",
-	"fb_dbg",
-	"fb_err",
-	"fb_info",
-	"fb_notice",
-	"fb_warn",
-	"fbtft_init_dbg",
-	"fbtft_par_dbg",
-	"fb_warn",
-	"FC_DISC_DBG",
-	"FC_EXCH_DBG",
-	"FC_RPORT_DBG",
-	"FC_SCSI_DBG",
-	"FC_FCP_DBG",
-	"FC_LPORT_DBG",
-	"FCOE_DBG",
-	"FCOE_NETDEV_DBG",
-	"FC_RPORT_ID_DBG",
-	"FCS_ONLINE",
-	"f_dddprintk",
-	"f_ddprintk",
-	"f_dprintk",
-	"fhci_dbg",
-	"fhci_err",
-	"fhci_info",
-	"fhci_vdbg",
-	"FIPS_DBG",
-	"FIPS_LOG",
-	"fit_dbg",
-	"fit_dbg_verbose",
-	"fit_pr",
-	"flow_dump",
-	"flow_log",
-	"fmdbg",
-	"fmerr",
-	"fmwarn",
-	"fotg210_dbg",
-	"fotg210_err",
-	"fotg210_info",
-	"fprintf",
-	"fputs",
-	"F_printk",
-	"fs_dprintk",
-	"fs_err",
-	"fs_info",
-	"fs_warn",
-	"fsl_mc_printk",
-	"fusb302_log",
-	"FW_BUG",
-	"fw_err",
-	"fw_notice",
-	"fwtty_dbg",
-	"fwtty_err",
-	"fwtty_err_ratelimited",
-	"fwtty_notice",
-	"gcam_dbg",
-	"gcam_err",
-	"gdbstub_printk",
-	"gfs2_print_dbg",
-	"gig_dbg",
-	"gossip_debug",
-	"gossip_err",
-	"gpio_mockup_err",
-	"gpiod_dbg",
-	"gdbstub_printk",
-	"gr_dbgprint_request",
-	"gru_abort",
-	"gru_dng",
-	"gspca_dbg",
-	"gspca_err",
-	"g_error",
-	"g_strdup_printf",
-	"gvt_dbg_cmd",
-	"gvt_dbg_core",
-	"gvt_dbg_el",
-	"gvt_dbg_irq",
-	"gvt_dbg_mm",
-	"gvt_dbg_mmio",
-	"gvt_dbg_render",
-	"gvt_dbg_sched",
-	"gvt_err",
-	"gvt_vgpu_err",
-	"hdmi_log",
-	"HEAD_DBG",
-	"hfi1_cdbg",
-	"hfi1_dbg_early",
-	"hfi1_early_err",
-	"hfi1_early_info",
-	"hfs_dbg",
-	"hfs_dbg_cont",
-	"hprintk",
-	"HPRINTK",
-	"hid_dbg",
-	"hid_debug_event",
-	"hid_err",
-	"hid_info",
-	"hid_warn",
-	"host1x_debug_output",
-	"hpfs_error",
-	"HPI_DEBUG_LOG",
-	"hprintk",
-	"HPRINTK",
-	"hpsa_show_dev_msg",
-	"hso_dbg",
-	"ht_dbg",
-	"ht_dbg_ratelimited",
-	"hwc_debug",
-	"hw_dbg",
-	"hw_err",
-	"hwc_debug",
-	"hw_dbg",
-	"i2c_cont",
-	"i2c_dbg",
-	"i2c_dprintk",
-	"i2c_hid_dbg",
-	"i40e_debug",
-	"i40iw_debug",
-	"i40iw_pr_err",
-	"i40iw_pr_info",
-	"i40iw_pr_warn",
-	"i5000_printk",
-	"i5400_printk",
-	"i7300_mc_printk",
-	"i7core_printk",
-	"i82875p_printk",
-	"i82975x_printk",
-	"i915_error_printf",
-	"I915_STATE_WARN",
-	"IA64_MCA_DEBUG",
-	"I915_STATE_WARN",
-	"IA_CSS_LOG",
-	"ia_css_print",
-	"IA_CSS_WARNING",
-	"IA64_MCA_DEBUG",
-	"ibmvfc_dbg",
-	"ibmvfc_log",
-	"ibss_dbg"
-	"icmp_error_log",
-	"icmpv6_error_log",
-	"ics_panic",
-	"ide_debug_log",
-	"ie31200_printk",
-	"IEEE80211_DEBUG",
-	"IEEE80211_DEBUG_DROP",
-	"IEEE80211_DEBUG_EAP",
-	"IEEE80211_DEBUG_FRAG",
-	"IEEE80211_DEBUG_MGMT",
-	"IEEE80211_DEBUG_QOS",
-	"IEEE80211_DEBUG_SCAN",
-	"IEEE80211_DEBUG_WX",
-	"IEEE80211_ERROR",
-	"IEEE80211_INFO",
-	"ieee802154_print_addr",
-	"IF_ABR",
-	"IF_CBR",
-	"IF_ERR",
-	"IF_EVENT",
-	"IF_INIT",
-	"IF_RX",
-	"IF_RXPKT",
-	"IF_TX",
-	"IF_TXPKT",
-	"IF_UBR",
-	"IL_ERR",
-	"IL_INFO",
-	"IL_WARN",
-	"IL_WARN_ONCE",
-	"ima_log_string",
-	"imm_fail",
-	"INF_MSG",
-	"info",
-	"INFO",
-	"inform",
-	"input_dbg",
-	"intc_irqpin_dbg",
-	"intel_pt_log",
-	"intel_pt_log_at",
-	"intel_pt_log_to",
-	"intel_pt_print_info_str",
-	"INTERNAL_DEBMSG",
-	"INTERNAL_ERRMSG",
-	"INTERNAL_INFMSG",
-	"INTERNAL_WRNMSG"
-	"INTPRINTK",
-	"ioapic_debug",
-	"iop_pr_cont",
-	"iop_pr_debug",
-	"IOR_DBG",
-	"ipoib_dbg",
-	"ipr_dbg",
-	"ipr_err",
-	"ipr_hcam_err",
-	"ipr_info",
-	"IPRINTK",
-	"ipr_phys_res_err",
-	"ipr_res_err",
-	"ipr_trace",
-	"ipoib_dbg",
-	"ipoib_dbg_mcast",
-	"ipoib_warn",
-	"IPS_PRINTK",
-	"IP_VS_DBG",
-	"IP_VS_DBG_RL",
-	"IP_VS_ERR_RL",
-	"ip_vs_scheduler_err",
-	"IPW_DEBUG",
-	"IPW_DEBUG_ASSOC",
-	"IPW_DEBUG_DROP",
-	"IPW_DEBUG_ERROR",
-	"IPW_DEBUG_FRAG",
-	"IPW_DEBUG_FW",
-	"IPW_DEBUG_FW_INFO",
-	"IPW_DEBUG_HC",
-	"IPW_DEBUG_INFO",
-	"IPW_DEBUG_IO",
-	"IPW_DEBUG_ISR",
-	"IPW_DEBUG_LED",
-	"IPW_DEBUG_MERGE",
-	"IPW_DEBUG_NOTIF",
-	"IPW_DEBUG_ORD",
-	"IPW_DEBUG_QOS",
-	"IPW_DEBUG_RF_KILL",
-	"IPW_DEBUG_RX",
-	"IPW_DEBUG_SCAN",
-	"IPW_DEBUG_STATS",
-	"IPW_DEBUG_TX",
-	"IPW_DEBUG_WEP",
-	"IPW_DEBUG_WX",
-	"IPW_ERROR",
-	"IPW_WARNING",
-	"ir_dbg",
-	"ir_dprintk",
-	"IR_dprintk",
-	"irqc_dbg",
-	"irq_dbg",
-	"irq_err",
-	"iscsi_conn_printk",
-	"ISCSI_DBG_CONN",
-	"ISCSI_DBG_EH",
-	"ISCSI_DBG_SESSION",
-	"ISCSI_DBG_TCP",
-	"ISCSI_DBG_TRANS_CONN",
-	"ISCSI_DBG_TRANS_SESSION",
-	"ISCSI_SW_TCP_DBG",
-	"iser_dbg",
-	"iser_err",
-	"iser_info",
-	"iser_warn",
-	"isert_dbg",
-	"isert_err",
-	"isert_info",
-	"isert_print_wc",
-	"isert_warn",
-	"isp_dbg",
-	"itd_dbg",
-	"itd_dbg_verbose",
-	"itd_info",
-	"itd_warn",
-	"ite_dbg",
-	"ite_dbg_verbose",
-	"ite_pr",
-	"IVTV_ALSA_ERR",
-	"IVTV_ALSA_INFO",
-	"IVTV_ALSA_WARN",
-	"IVTV_DEBUG_ALSA_INFO",
-	"IVTV_DEBUG_DMA",
-	"IVTV_DEBUG_FILE",
-	"IVTV_DEBUG_HI_DMA",
-	"IVTV_DEBUG_HI_FILE",
-	"IVTV_DEBUG_HI_I2C",
-	"IVTV_DEBUG_HI_IRQ",
-	"IVTV_DEBUG_HI_MB",
-	"IVTV_DEBUG_I2C",
-	"IVTV_DEBUG_INFO",
-	"IVTV_DEBUG_IOCTL",
-	"IVTV_DEBUG_IRQ",
-	"IVTV_DEBUG_MB",
-	"IVTV_DEBUG_WARN",
-	"IVTV_DEBUG_YUV",
-	"IVTV_ERR",
-	"IVTVFB_DEBUG_INFO",
-	"IVTVFB_DEBUG_WARN",
-	"IVTVFB_ERR",
-	"IVTVFB_INFO",
-	"IVTVFB_WARN",
-	"IVTV_INFO",
-	"IVTV_WARN",
-	"IWL_DEBUG_11H",
-	"IWL_DEBUG_ASSOC",
-	"IWL_DEBUG_CALIB",
-	"IWL_DEBUG_COEX",
-	"IWL_DEBUG_DEV",
-	"IWL_DEBUG_DEV_RADIO",
-	"IWL_DEBUG_DROP",
-	"IWL_DEBUG_EEPROM",
-	"IWL_DEBUG_FW",
-	"IWL_DEBUG_HC",
-	"IWL_DEBUG_HT",
-	"IWL_DEBUG_INFO",
-	"IWL_DEBUG_ISR",
-	"IWL_DEBUG_LAR",
-	"IWL_DEBUG_MAC80211",
-	"IWL_DEBUG_POWER",
-	"IWL_DEBUG_QUIET_RFKILL",
-	"IWL_DEBUG_QUOTA",
-	"IWL_DEBUG_RADIO",
-	"IWL_DEBUG_RATE",
-	"IWL_DEBUG_RATE_LIMIT",
-	"IWL_DEBUG_RF_KILL",
-	"IWL_DEBUG_RPM",
-	"IWL_DEBUG_RX",
-	"IWL_DEBUG_SCAN",
-	"IWL_DEBUG_STATS",
-	"IWL_DEBUG_STATS_LIMIT",
-	"IWL_DEBUG_TDLS",
-	"IWL_DEBUG_TE",
-	"IWL_DEBUG_TEMP",
-	"IWL_DEBUG_TX",
-	"IWL_DEBUG_TX_QUEUES",
-	"IWL_DEBUG_TX_REPLY",
-	"IWL_DEBUG_WEP",
-	"IWL_ERR",
-	"IWL_ERR_DEV",
-	"IWL_INFO",
-	"IWL_WARN",
-	"IX25DEBUG",
-	"jbd_debug",
-	"jent_panic",
-	"jffs2_dbg"
-	"JFFS2_DEBUG",
-	"JFFS2_ERROR",
-	"JFFS2_NOTICE",
-	"JFFS2_WARNING",
-	"jfs_err",
-	"jfs_error",
-	"jfs_info",
-	"jfs_warn",
-	"jsm_dbg",
-	"K1212_DEBUG_PRINTK",
-	"K1212_DEBUG_PRINTK_VERBOSE",
-	"kasprintf",
-	"kdb_printf",
-	"kdcore",
-	"kdebug",
-	"KINFO",
-	"kmemleak_stop",
-	"kmemleak_warn",
-	"kputs",
-	"kvasprintf",
-	"kvm_debug",
-	"kvm_debug_ratelimited",
-	"kvm_err",
-	"KVM_EVENT",
-	"kvm_info",
-	"kvm_pr_debug_ratelimited",
-	"kvm_pr_err_ratelimited",
-	"kvm_pr_unimpl",
-	"l2m_debug",
-	"l2tp_dbg",
-	"l2tp_info",
-	"l3_debug",
-	"lapb_dbg",
-	"LCONSOLE_ERROR",
-	"LCONSOLE_ERROR_MSG",
-	"LCONSOLE_INFO",
-	"LCONSOLE_WARN",
-	"LDBG",
-	"ldcdbg",
-	"LDLM_DEBUG",
-	"LDLM_DEBUG_NOLOCK",
-	"LDLM_ERROR",
-	"ldm_crit",
-	"ldm_debug",
-	"ldm_error",
-	"ldm_info",
-	"led_print",
-	"lg_dbg",
-	"lg_debug",
-	"lg_err",
-	"lg_reg",
-	"lg_warn",
-	"libcfs_debug_msg",
-	"LIBFCOE_TRANSPORT_DBG",
-	"LIBFCOE_FIP_DBG",
-	"LIBFCOE_SYSFS_DBG",
-	"LIBIPW_DEBUG_DROP",
-	"LIBIPW_DEBUG_FRAG",
-	"LIBIPW_DEBUG_INFO",
-	"LIBIPW_DEBUG_MGMT",
-	"LIBIPW_DEBUG_QOS",
-	"LIBIPW_DEBUG_SCAN",
-	"LIBIPW_DEBUG_WX",
-	"LIBIPW_ERROR",
-	"link_debug",
-	"link_print",
-	"log",
-	"LOG",
-	"LOG_BLOB",
-	"LOG_DBG",
-	"log_debug",
-	"log_bug",
-	"log_err",
-	"LOG_ERROR",
-	"log_error",
-	"LOG_INFO",
-	"log_info",
-	"LOG_PARSE",
-	"log_print",
-	"LOG_WARN",
-	"log_warn",
-	"mb_debug",
-	"mce_panic",
-	"mcg_debug_group",
-	"mcg_warn",
-	"mcg_warn_group",
-	"mc_printk",
-	"mcsa_dbg",
-	"mei_err",
-	"mei_msg",
-	"merror",
-	"message",
-	"memblock_dbg",
-	"merror",
-	"METHOD_TRACE",
-	"mfc_debug",
-	"mfc_err",
-	"mfc_err_limited",
-	"mfd_fail_new",
-	"mhwmp_dbg",
-	"MG_DBG",
-	"mips_display_message",
-	"mmiotrace_printk",
-	"mlme_dbg",
-	"mlog",
-	"mlog_bug_on_msg",
-	"mlx4_dbg",
-	"mlx4_err",
-	"mlx4_ib_warn",
-	"mlx4_info",
-	"mlx4_warn",
-	"mlx5_core_dbg",
-	"mlx5_core_err",
-	"mlx5_core_info",
-	"mlx5_core_warn",
-	"mlx5_fpga_dbg",
-	"mlx5_fpga_err",
-	"mlx5_fpga_info",
-	"mlx5_fpga_warn",
-	"mlx5_fpga_warn_ratelimited",
-	"mlx5_ib_dbg",
-	"mlx5_ib_err",
-	"mlx5_ib_warn",
-	"mmiotrace_printk",
-	"mpath_dbg",
-	"mpath_dbg",
-	"mprintk",
-	"mps_dbg",
-	"mod_debug",
-	"mod_err",
-	"mpath_dbg",
-	"mpl_dbg",
-	"mprintk",
-	"mpsslog",
-	"msg",
-	"MSG",
-	"MSG_8192C",
-	"MSG_88E",
-	"msync_dbg",
-	"mthca_dbg",
-	"mthca_err",
-	"mthca_warn",
-	"mtk_mdp_dbg",
-	"mtk_mdp_err",
-	"mtk_v4l2_debug",
-	"mtk_v4l2_err",
-	"mtk_vcodec_debug",
-	"mtk_vcodec_err",
-	"MTS_DEBUG",
-	"MTS_ERROR",
-	"mus_dbg",
-	"mv_dprintk",
-	"mv_printk",
-	"mwifiex_dbg",
-	"mxl_dbg",
-	"mxl_debug",
-	"mxl_debug_adv",
-	"mxl_i2c",
-	"mxl_i2c_adv",
-	"mxl_info",
-	"mxl_warn",
-	"mxm_dbg",
-	"mxm_err,"
-	"ncp_dbg",
-	"ncp_vdbg",
-	"ND_PRINK"
-	"neigh_dbg",
-	"nes_debug",
-	"NDD_TRACE",
-	"net_crit_ratelimited",
-	"net_dbg_ratelimited",
-	"netdev_alert",
-	"netdev_crit",
-	"netdev_dbg",
-	"netdev_emerg",
-	"netdev_err",
-	"netdev_info",
-	"netdev_notice",
-	"NETDEV_PR_FMT",
-	"netdev_printk",
-	"netdev_vdbg",
-	"netdev_warn",
-	"netdev_WARN",
-	"net_err_ratelimited",
-	"netif_crit",
-	"netif_dbg",
-	"netif_err",
-	"netif_info",
-	"netif_notice",
-	"netif_printk",
-	"netif_vdbg",
-	"netif_warn",
-	"net_info_ratelimited",
-	"net_notice_ratelimited",
-	"net_warn_ratelimited",
-	"nfc_err",
-	"nfc_info",
-	"NFCSIM_DBG",
-	"NFCSIM_ERR",
-	"NFDEBUG",
-	"nfp_err",
-	"nfp_info",
-	"nfp_warn",
-	"nilfs_error",
-	"nilfs_msg",
-	"nmi_debug",
-	"nmi_panic",
-	"nn_dbg",
-	"nn_dp_warn",
-	"nn_err",
-	"nn_info",
-	"nn_warn",
-	"noisy_printk",
-	"non_fatal",
-	"no_printk",
-	"NPRINTK",
-	"np_err",
-	"np_info",
-	"np_notice",
-	"NS_DBG",
-	"NS_ERR",
-	"NS_INFO",
-	"NS_LOG",
-	"NS_WARN",
-	"nsp32_dbg",
-	"nsp32_msg",
-	"nsp_dbg",
-	"nsp_msg",
-	"ntfs_debug",
-	"ntfs_error",
-	"ntfs_warning",
-	"numadbg",
-	"nvdev_error",
-	"nvdev_info",
-	"nvdev_trace",
-	"NV_ERROR",
-	"NV_WARN",
-	"nvif_debug",
-	"nvif_error",
-	"nvif_fatal",
-	"nvif_ioctl",
-	"nvif_trace",
-	"nvkm_debug",
-	"nvkm_error",
-	"nvkm_fatal",
-	"nvkm_info",
-	"nvkm_printk",
-	"nvkm_trace",
-	"nvkm_warn",
-	"nvt_dbg",
-	"nvt_dbg_verbose",
-	"ocb_dbg",
-	"ocfs2_error",
-	"ocfs2_log_dlm_error",
-	"ohci_dbg",
-	"ohci_dbg_sw",
-	"ohci_err",
-	"ohci_notice",
-	"ohci_warn",
-	"OPRINTK",
-	"ORE_DBGMSG",
-	"ORE_DBGMSG2",
-	"ORE_ERR",
-	"OSC_IO_DEBUG",
-	"OSD_DEBUG",
-	"OSD_ERR",
-	"OSDBLK_DEBUG",
-	"OSD_DEBUG",
-	"OSD_ERR",
-	"OSD_INFO",
-	"OSD_SENSE_PRINT1",
-	"OSD_SENSE_PRINT2",
-	"OUTP_DBG",
-	"OUTP_ERR",
-	"oxu_dbg",
-	"oxu_err",
-	"oxu_info",
-	"oxu_vdbg",
-	"p9_debug",
-	"packet_log",
-	"pair_err",
-	"pair_dbg",
-	"pair_err",
-	"panic",
-	"PANIC",
-	"parse_err",
-	"pch_dbg",
-	"pch_err",
-	"pch_pci_dbg",
-	"pch_pci_err",
-	"__pcidebug",
-	"pci_dbg",
-	"pci_err",
-	"pci_info",
-	"pci_note_irq_problem",
-	"pci_notice",
-	"pci_printk",
-	"pci_warn",
-	"pcm_dbg",
-	"pcm_err",
-	"pcr_dbg",
-	"PDBG",
-	"PDEBUG",
-	"pdprintf",
-	"PDPRINTK",
-	"pdtlb_kernel",
-	"pe_err",
-	"pe_info",
-	"pe_warn",
-	"PERR",
-	"perror",
-	"PERROR",
-	"pgd_ERROR",
-	"pgprintk",
-	"phydev_dbg",
-	"phydev_err",
-	"phx_mmu",
-	"phx_warn",
-	"PHYDM_SNPRINTF",
-	"PHY_ERR",
-	"p_info",
-	"pid_dbg_print",
-	"pio_rx_error",
-	"PINFO",
-	"pk_error",
-	"pkt_dbg",
-	"pkt_err",
-	"pkt_info",
-	"pkt_notice",
-	"PKT_ERROR",
-	"PM8001_DISC_DBG",
-	"PM8001_EH_DBG",
-	"PM8001_FAIL_DBG",
-	"PM8001_IO_DBG",
-	"PM8001_MSG_DBG",
-	"pm8001_printk",
-	"pmcraid_err",
-	"pmcraid_info",
-	"pm_dev_dbg",
-	"pm_pr_dbg",
-	"pmd_ERROR",
-	"pmz_debug",
-	"pmz_error",
-	"pmz_info",
-	"pnd2_mc_printk",
-	"pnd2_printk",
-	"pnp_dbg",
-	"pnp_printf",
-	"pnpbios_print_status",
-	"ppa_fail",
-	"ppc4xx_edac_mc_printk",
-	"ppc4xx_edac_printk",
-	"PP_DBG_LOG",
-	"pr",
-	"PR",
-	"pr2",
-	"pr_alert",
-	"pr_alert_once",
-	"pr_alert_ratelimited",
-	"pr_cont",
-	"pr_cont_once",
-	"pr_crit",
-	"pr_crit_once",
-	"pr_crit_ratelimited",
-	"pr_debug",
-	"pr_debug2",
-	"pr_debug3",
-	"pr_debug4",
-	"pr_debug_once",
-	"pr_debug_ratelimited",
-	"pr_define",
-	"pr_devel",
-	"pr_devel_once",
-	"pr_devel_ratelimited",
-	"pr_devinit",
-	"PR_DEVEL",
-	"pr_efi",
-	"pr_efi_err",
-	"pr_emerg",
-	"pr_emerg_once",
-	"pr_emerg_ratelimited",
-	"pr_err",
-	"pr_err_once",
-	"pr_err_ratelimited",
-	"pr_err_with_code",
-	"pr_fmt",
-	"pr_hard",
-	"pr_hardcont",
-	"pr_info",
-	"pr_info_ipaddr",
-	"pr_info_once",
-	"pr_info_ratelimited",
-	"pr_init",
-	"print",
-	"PRINT",
-	"PRINT_ADDR",
-	"PRINT_ATTR",
-	"PRINT_CCK_RATE",
-	"PRINT_CLOCK",
-	"PRINT_CMD",
-	"print_credit_info",
-	"printd",
-	"PRINTD",
-	"PRINTDB",
-	"print_dpcm_info",
-	"print_dbg",
-	"PRINT_DEBUG",
-	"print_err",
-	"PRINT_ERR",
-	"PRINT_FCALL_ERROR",
-	"printf",
-	"PRINTF",
-	"printf_alert",
-	"PRINT_FATAL",
-	"PRINT_FIELD",
-	"printf_crit",
-	"printf_debug",
-	"printf_err",
-	"printf_info",
-	"printf_notice",
-	"printf_warning",
-	"print_info",
-	"PRINT_INFO",
-	"printk",
-	"PRINTK",
-	"PRINTK2",
-	"PRINTK_2",
-	"PRINTK3",
-	"PRINTK_5",
-	"printk_deferred",
-	"printk_deferred_once",
-	"printk_emit",
-	"PRINTK_ERROR",
-	"PRINTKE",
-	"PRINTKI",
-	"printk_once",
-	"printk_ratelimited",
-	"print_lockdep_off",
-	"PRINT_MASKED_VAL",
-	"PRINT_MASKED_VAL_L2",
-	"PRINT_MASKED_VAL_MISC",
-	"PRINT_MASKED_VALP",
-	"printl",
-	"print_message",
-	"print_metric",
-	"print_symbol",
-	"print_temp",
-	"print_testname",
-	"print_track",
-	"print_warn",
-	"PRINT_WARN",
-	"PRINTR",
-	"printv",
-	"pr_notice",
-	"pr_notice_once",
-	"pr_notice_ratelimited",
-	"PROBE_DEBUG",
-	"prom_debug",
-	"prom_panic",
-	"prom_print",
-	"prom_printf",
-	"prom_reboot",
-	"prom_stdout",
-	"prom_warn",
-	"prop_warn",
-	"pr_probe",
-	"pr_stat",
-	"pr_trace",
-	"pr_vdebug",
-	"pr_vlog",
-	"pr_warn",
-	"pr_warning",
-	"pr_warning_once",
-	"pr_warn_once",
-	"pr_warn_ratelimited",
-	"prx",
-	"ps_dbg",
-	"psmouse_dbg",
-	"psmouse_err",
-	"psmouse_info",
-	"psmouse_printk",
-	"psmouse_warn",
-	"puts",
-	"puts_raw",
-	"putstr",
-	"PWARN",
-	"PWC_DEBUG_FLOW",
-	"PWC_DEBUG_IOCTL",
-	"PWC_DEBUG_MEMORY",
-	"PWC_DEBUG_OPEN",
-	"PWC_DEBUG_PROBE",
-	"PWC_DEBUG_SIZE",
-	"PWC_ERROR",
-	"PWC_INFO",
-	"PWC_TRACE",
-	"PWC_WARNING",
-	"Py_FatalError",
-	"qdisc_warn_nonwc",
-	"QDUMP",
-	"QERROR",
-	"QEDF_ERR",
-	"QEDF_INFO",
-	"QEDF_WARN",
-	"QEDI_ERR",
-	"QEDI_INFO",
-	"QEDI_NOTICE",
-	"QEDI_WARN",
-	"qib_dev_err",
-	"qib_devinfo",
-	"qib_dev_porterr",
-	"ql4_printk",
-	"ql_dbg",
-	"ql_log",
-	"quota_error",
-	"qxl_io_log",
-	"raid10_log",
-	"raid1_log",
-	"rbd_warn",
-	"RBRQ_HBUF_ERR",
-	"RCU_LOCKDEP_WARN",
-	"rdev_dbg",
-	"rdev_err",
-	"rdev_info",
-	"rdev_warn",
-	"rds_ib_conn_error",
-	"rdrif_dbg",
-	"rdrif_err",
-	"rdsdebug",
-	"RDBG",
-	"r128_print_dirty",
-	"r_ddprintk",
-	"r_dprintk",
-	"regs__printf",
-	"rdsdebug",
-	"REFCOUNT_WARN",
-	"reiserfs_abort",
-	"reiserfs_error",
-	"reiserfs_info",
-	"reiserfs_panic",
-	"reiserfs_printk",
-	"reiserfs_warning",
-	"report",
-	"RGMII_DBG",
-	"RGMII_DBG2",
-	"riocm_debug",
-	"riocm_error",
-	"riocm_warn",
-	"rl_printf",
-	"rmap_printk",
-	"rmcd_debug",
-	"rmcd_error",
-	"rmcd_warn",
-	"rmi_dbg",
-	"RPRINTK",
-	"RTL_DEBUG",
-	"RT_TRACE",
-	"rt2x00_dbg",
-	"rt2x00_eeprom_dbg",
-	"rt2x00_err",
-	"rt2x00_info",
-	"rt2x00_probe_err",
-	"rt2x00_warn",
-	"RTL_DEBUG",
-	"RPRINT",
-	"RWDEBUG",
-	"rvt_pr_err",
-	"rvt_pr_info",
-	"RXD",
-	"RXPRINTK",
-	"RXS_ERR",
-	"s3c_freq_dbg",
-	"s3c_freq_iodbg",
-	"rmcd_error",
-	"rmcd_warn",
-	"RPRINTK",
-	"RTL_DEBUG",
-	"RT_TRACE",
-	"RWDEBUG",
-	"RXD",
-	"RXPRINTK",
-	"RXS_ERR",
-	"s2255_dev_err",
-	"s3c_freq_dbg",
-	"s3c_freq_iodbg",
-	"S3C_PMDBG",
-	"SAS_DPRINTK",
-	"sas_ata_printk",
-	"sas_printk",
-	"sbridge_mc_printk",
-	"sbridge_printk",
-	"sclp_early_printk",
-	"scrub_print_warning",
-	"sched_numa_warn",
-	"scif_err_debug",
-	"sclp_early_printk",
-	"scmd_printk",
-	"SCM_LOG",
-	"scnprintf",
-	"__sdata_dbg",
-	"__sdata_err",
-	"sdata_err",
-	"__sdata_info",
-	"sdata_info",
-	"SDEBUG",
-	"sdev_printk",
-	"sd_first_printk",
-	"SDMA_DBG",
-	"sd_printk",
-	"se_kernmode_warn",
-	"semantic_error",
-	"SEQ_OPTS_PRINT",
-	"SEQ_OPTS_PUTS",
-	"seq_buf_printf",
-	"seq_printf",
-	"seq_puts",
-	"SEQ_printf",
-	"setup_early_printk",
-	"shost_printk",
-	"sil164_dbg",
-	"sil164_err",
-	"sil164_info",
-	"skx_mc_printk",
-	"skx_printk",
-	"slab_bug",
-	"slab_err",
-	"slab_error",
-	"slab_fix",
-	"slice_dbg",
-	"sm_printk",
-	"SMP_DBG",
-	"smp_debug",
-	"sm_printk",
-	"SMSC_TRACE",
-	"SMSC_WARN",
-	"SMT_PANIC",
-	"snd_iprintf",
-	"snd_printd",
-	"snd_printdd",
-	"snd_printddd",
-	"snd_printk",
-	"SNIC_DBG",
-	"SNIC_DISC_DBG",
-	"SNIC_ERR",
-	"SNIC_HOST_ERR",
-	"SNIC_HOST_INFO",
-	"SNIC_INFO",
-	"SNIC_SCSI_DBG",
-	"snprintf",
-	"sprintf",
-	"SOCK_DEBUG",
-	"sock_warn_obsolete_bsdism",
-	"sprintf",
-	"sprinthx",
-	"sprinthx4",
-	"srm_printk",
-	"sr_printk",
-	"ssb_cont",
-	"ssb_dbg",
-	"ssb_emerg",
-	"ssb_err",
-	"ssb_info",
-	"ssb_notice",
-	"ssb_warn",
-	"SSI_LOG",
-	"SSI_LOG_DEBUG",
-	"SSI_LOG_ERR",
-	"SSI_LOG_INFO",
-	"ssp_dbg",
-	"sta_dbg",
-	"starget_printk",
-	"stk1160_dbg",
-	"stk1160_err",
-	"stk1160_info",
-	"stk1160_warn",
-	"STK_ERROR",
-	"STK_INFO",
-	"st_printk",
-	"str_printf",
-	"svc_printk",
-	"SWARN",
-	"swim3_dbg",
-	"swim3_err",
-	"swim3_info",
-	"swim3_warn",
-	"synth_printf",
-	"tb_ctl_info",
-	"tb_ctl_warn",
-	"tb_ctl_WARN",
-	"tb_err",
-	"tb_info",
-	"tb_port_info",
-	"tb_port_warn",
-	"tb_port_WARN",
-	"tb_sw_info",
-	"tb_sw_info",
-	"tb_sw_warn",
-	"tb_sw_WARN",
-	"tb_tunnel_info",
-	"tb_tunnel_warn",
-	"tb_tunnel_WARN",
-	"tb_warn",
-	"tb_WARN",
-	"tcp_error_log",
-	"tcpm_log",
-	"tda_cal",
-	"tda_dbg",
-	"tda_err",
-	"tda_info",
-	"tda_map",
-	"tda_reg",
-	"tda_warn",
-	"tdls_dbg",
-	"tgt_dbg",
-	"tgt_err",
-	"tgt_info",
-	"tgt_log",
-	"tipc_tlv_sprintf",
-	"TLAN_DBG",
-	"tm6000_err",
-	"tmon_log",
-	"TM_DEBUG",
-	"tomoyo_io_printf",
-	"TP_printk",
-	"TP_printk_btrfs",
-	"tprintf",
-	"TRACE",
-	"TRACE2",
-	"TRACE3",
-	"trace_eeprom",
-	"trace_firmware",
-	"trace_i2c",
-	"trace_printk",
-	"trace_seq_printf",
-	"trace_regcache_sync",
-	"trace_rvt_dbg",
-	"trace_seq_printf",
-	"trace_seq_puts",
-	"trace_snd_soc_jack_irq",
-	"ts_debug",
-	"tsi_debug",
-	"tsi_err",
-	"tsi_info",
-	"TTM_DEBUG",
-	"tty_debug",
-	"tty_debug_hangup",
-	"tty_debug_wait_until_sent",
-	"tty_err",
-	"tty_info_ratelimited",
-	"tty_ldisc_debug",
-	"tty_notice",
-	"tty_warn",
-	"tty_write_message",
-	"tuner_dbg",
-	"tuner_err",
-	"tuner_info",
-	"tuner_warn",
-	"TWDEBUG",
-	"TW_PRINTK",
-	"tx_dbg",
-	"TXPRINTK",
-	"ubi_err",
-	"ubifs_err",
-	"ubifs_errc",
-	"ubifs_msg",
-	"ubifs_warn",
-	"ubi_msg",
-	"ubi_warn",
-	"udbg_printf",
-	"udbg_puts",
-	"udbg_write",
-	"udf_debug",
-	"udf_err",
-	"udf_info",
-	"udf_warn",
-	"udp_error_log",
-	"udplite_error_log",
-	"uea_dbg",
-	"uea_err",
-	"uea_info",
-	"uea_vdbg",
-	"uea_warn",
-	"ufs_error",
-	"ufs_panic",
-	"ufs_warning",
-	"ugeth_vdbg",
-	"ultra_iprintf",
-	"unaligned_panic",
-	"unaligned_printk",
-	"unpoison_pr_info",
-	"unw_debug",
-	"uprobe_warn",
-	"urb_dbg",
-	"URB_DBG",
-	"URB_DPRINT",
-	"usb_audio_dbg",
-	"usb_audio_err",
-	"usb_audio_info",
-	"usb_dbg",
-	"usb_err",
-	"usb_info",
-	"usb_warn",
-	"usbip_dbg_eh",
-	"usbip_dbg_stub_rx",
-	"usbip_dbg_stub_tx",
-	"usbip_dbg_vhci_hc",
-	"usbip_dbg_vhci_rh",
-	"usbip_dbg_vhci_rx",
-	"usbip_dbg_vhci_sysfs",
-	"usbip_dbg_vhci_tx",
-	"usbip_dbg_xmit",
-	"usb_stor_dbg",
-	"user_log_dlm_error",
-	"usnic_dbg",
-	"usnic_err",
-	"usnic_info",
-	"uvc_printk",
-	"uvc_trace",
-	"v1printk",
-	"v2printk",
-	"v4l2_dbg",
-	"v4l2_err",
-	"v4l2_info",
-	"v4l2_warn",
-	"v4l_dbg",
-	"v4l_err",
-	"v4l_info",
-	"v4l_warn",
-	"var_printf",
-	"vbi_dbg",
-	"vbg_err",
-	"v_dbg",
-	"vbprintf",
-	"vchiq_log_error",
-	"vchiq_log_info",
-	"vchiq_log_trace",
-	"vchiq_log_warning",
-	"vchiq_loud_error",
-	"vcpu_debug",
-	"vcpu_debug_ratelimited",
-	"vcpu_err",
-	"VCPU_EVENT",
-	"VCPU_TP_PRINTK",
-	"vcpu_unimpl",
-	"vdbg_printk",
-	"VDBG",
-	"VDEB",
-	"VDEBUG",
-	"vdev_err",
-	"vdev_neterr",
-	"vdev_netwarn",
-	"vdev_warn",
-	"vdprintf",
-	"VDBG",
-	"VDEB",
-	"v_err",
-	"verbose",
-	"verbose_debug",
-	"verbose_printk",
-	"vfprintf",
-	"vfp_panic",
-	"vgaarb_dbg",
-	"vgaarb_err",
-	"vgaarb_info"
-	"video_dbg",
-	"vin_dbg",
-	"vin_err",
-	"viodbg",
-	"VLDBG",
-	"VMM_DEBUG",
-	"vmci_ioctl_err",
-	"vpe_dbg",
-	"vpe_err",
-	"vpfe_dbg",
-	"vpfe_err",
-	"vpfe_info",
-	"vpif_dbg",
-	"vpif_err",
-	"vpr_info",
-	"vpr_info_dq",
-	"vprint",
-	"VPRINTK",
-	"vprintf",
-	"vprintk",
-	"VPRINTK",
-	"vprintk_emit",
-	"vq_err",
-	"vsnprintf",
-	"vsprintf",
-	"v_warn",
-	"wait_err",
-	"wait_warn",
-	"warn",
-	"WARN",
-	"WARN_FUNC",
-	"warning",
-	"WARNING",
-	"warn_invalid_dmar",
-	"WARN_ON",
-	"WARN_ONCE",
-	"WARN_ON_ONCE",
-	"__WARN_printf",
-	"WARN_RATELIMIT",
-	"warnx",
-	"WASM",
-	"wcn36xx_dbg",
-	"wcn36xx_err",
-	"wcn36xx_info",
-	"wcn36xx_warn",
-	"whc_hw_error",
-	"wil_dbg_fw",
-	"wil_dbg_irq",
-	"wil_dbg_misc",
-	"wil_dbg_pm",
-	"wil_dbg_ratelimited",
-	"wil_dbg_txrx",
-	"wil_dbg_wmi",
-	"wil_err",
-	"wil_err_fw",
-	"__wil_err_ratelimited",
-	"wil_info",
-	"wiphy_dbg",
-	"wiphy_debug",
-	"wiphy_err",
-	"wiphy_info",
-	"wiphy_notice",
-	"wiphy_warn",
-	"wl1251_debug",
-	"wl1251_error",
-	"wl1251_info",
-	"wl1251_notice",
-	"wl1251_warning",
-	"wl1271_debug",
-	"wl1271_error",
-	"wl1271_info",
-	"wl1271_notice",
-	"wl1271_warning",
-	"WRN_MSG",
-	"xasprintf",
-	"xdi_dbg_xlog",
-	"xenbus_dev_error",
-	"xenbus_dev_fatal",
-	"xenbus_printf",
-	"xen_raw_console_write",
-	"xen_raw_printk",
-	"xfs_alert",
-	"xfs_crit",
-	"xfs_info",
-	"xfs_debug",
-	"xfs_emerg",
-	"xfs_notice",
-	"xfs_warn",
-	"XFS_CORRUPTION_ERROR",
-	"XFS_ERROR_REPORT",
-	"xhci_dbg",
-	"xhci_dbg_trace",
-	"xhci_err",
-	"xhci_info",
-	"xhci_warn",
-	"XICS_DBG",
-	"xmon_printf",
-	"XPRINTK",
-	"XXDEBUG",
-	"YYFPRINTF",
-	"zconf_error",
-	"z_error",
-	"zip_dbg",
-	"zip_err",
-	"zip_msg",
-	"ZMII_DBG",
-	"ZMII_DBG2",
-	"zpa2326_dbg",
-	"zpa2326_err",
-	"zpa2326_warn",
-	"zpci_err",
-	"zswap_pool_debug",
-};
+ *  minimized DAWG of dictionary words, the default
+ *  is an empty root node with no edges
+ */
+static dawg_node_t dawg_empty;
+static dawg_node_t *dawg_nodes = &dawg_empty;
+static uint32_t *dawg_edges;
+static uint32_t dawg_root;
+static uint32_t dawg_node_count;
+static uint32_t dawg_edge_count;
+static double dawg_lookup_rate;
+static bool dict_benchmark;	/* measure lookups after loading a word list */
+static uint32_t dict_lanes = 1;	/* words check_unique_words() looks up at once */
 
-static uint8_t mapping[256] ALIGNED(64);
+/*
+ *  Tables built by mktables: the character class tables and
+ *  their scan_class_t bits, the format specifier DFA and the
+ *  printk like function names in a minimal perfect hash, with
+ *  name lengths and leading character pairs to reject most
+ *  identifiers before hashing
+ */
+#include "kernelscan-tables.h"
 
-static void set_mapping(void)
-{
-	size_t i;
+/*
+ *  hash table of bad spellings, worker 0 uses this and the
+ *  other workers get merged into it at the end of the scan
+ */
+static spelling_table_t spellings;
 
-	for (i = 0; i < SIZEOF_ARRAY(mapping); i++) {
-		mapping[i] = BAD_MAPPING;
-	}
-	for (i = 'a'; i <= 'z'; i++) {
-		mapping[i] = i - 'a';
-	}
-	for (i = 'A'; i <= 'Z'; i++) {
-		mapping[i] = i - 'A';
-	}
-	for (i = '0'; i <= '9'; i++) {
-		mapping[i] = 26;
-	}
-	mapping['_'] = 26;
-}
+/*
+ *  parser workers and the lock serialising their output
+ */
+static worker_t *workers;
+static context_t *walk_contexts;
+static buffer_pool_t buffer_pool = { PTHREAD_MUTEX_INITIALIZER, 0, 0, { NULL } };
+static walk_pool_t walk_pool = {
+	PTHREAD_MUTEX_INITIALIZER,
+	PTHREAD_COND_INITIALIZER,
+	NULL, 0, 0, 0
+};
+static pthread_mutex_t output_lock = PTHREAD_MUTEX_INITIALIZER;
 
 static inline get_char_t CONST PURE HOT map(register const get_char_t ch)
 {
@@ -2598,21 +781,18 @@ static inline size_t CONST PURE HOT token_len(register token_t *t)
 }
 
 /*
- *  djb2a()
- *	relatively fast string hash
+ *  FNV-1a hash of a word
  */
-static inline uint32_t TARGET_CLONES CONST PURE HOT djb2a(register const char *str)
+static inline uint32_t PURE HOT word_hash(register const char *str, register size_t len)
 {
-        register uint32_t c;
-        register uint32_t hash = 5381;
+	register uint32_t hash = 2166136261U;
 
-        while (LIKELY(c = *str++))
-                hash = (hash * 33) ^ c;
+	while (len--)
+		hash = (hash ^ (uint8_t)*str++) * 16777619U;
 
-        return hash & HASH_MASK;
+	return hash;
 }
 
-static int parse_file(char *RESTRICT path, const mqd_t mq);
 
 static void NORETURN out_of_memory(void)
 {
@@ -2622,191 +802,70 @@ static void NORETURN out_of_memory(void)
 }
 
 /*
- *  index_unpack_ptr()
- *	gcc-9 really dislikes taking the address of an element
- *	from a packed struct. However, to keep the cache hit
- *	low, the misalignment vs cache penalty is worthwhile.
- *	This is a horrible hack to silence the warnings. I'm sure
- *	gcc will figure this out sometime in the future.
- *	As it stands, this inlined function has no overhead as
- *	the optimizer does the right thing.
+ *  Perfect hash slot for a name's word_hash() given the
+ *  displacement of its bucket, mktables uses the same mix
  */
-static inline index_t *index_unpack_ptr(
-	register word_node_t *RESTRICT node,
-	register get_char_t ch)
-{
-	register void *vptr = (void *)&node->word_node_index[ch];
-
-	return (index_t *)vptr;		/* Cast away our sins */
-}
-
-static inline void HOT add_word(
-	register char *RESTRICT str,
-	register word_node_t *RESTRICT node,
-	register word_node_t *RESTRICT node_heap,
-	register word_node_t **RESTRICT node_heap_next,
-	const ssize_t heap_size)
+static inline uint32_t CONST HOT printk_hash_slot(register uint32_t hash, const uint32_t disp)
 {
-	register get_char_t ch;
-
-	if ((*node_heap_next - node_heap) >= heap_size)
-		out_of_memory();
-
-	ch = map(*str);
-
-	if (LIKELY(ch != BAD_MAPPING)) {
-		register index_t *RESTRICT ptr = index_unpack_ptr(node, ch);
-		register word_node_t *new_node;
-#if defined(PACKED_INDEX)
-		register uint32_t index32 = ((uint32_t)ptr->hi8 << 16) | ptr->lo16;
-#else
-		register uint32_t index32 = ptr->lo32;
-#endif
-
-		if (index32) {
-			new_node = &node_heap[index32];
-		} else {
-			new_node = *node_heap_next;
-			index32 = new_node - node_heap;
-			(*node_heap_next)++;
-
-#if defined(PACKED_INDEX)
-			ptr->hi8 = index32 >> 16;
-			ptr->lo16 = index32;
-#else
-			ptr->lo32 = index32;
-#endif
-		}
-		add_word(++str, new_node, node_heap, node_heap_next, heap_size);
-	} else {
-		node->eow = true;
-	}
+	hash += disp * 0x9e3779b9U;
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bU;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35U;
+	hash ^= hash >> 16;
+
+	return (uint32_t)(((uint64_t)hash * PRINTK_HASH_SIZE) >> 32);
 }
 
-static inline bool HOT find_word(
+/*
+ *  Is word exactly a printk like function name? Most words
+ *  are rejected on their length or first two characters
+ *  before being hashed into the one slot they could be in
+ */
+static inline bool HOT printk_find(
 	register const char *RESTRICT word,
-	register word_node_t *RESTRICT node,
-	register word_node_t *RESTRICT node_heap)
-{
-	for (;;) {
-		register get_char_t ch;
-		register index_t *ptr;
-		register uint32_t index32;
-
-		if (UNLIKELY(!node))
-			return false;
-		ch = *word;
-		if (!ch)
-			return node->eow;
-		ch = map(ch);
-		if (LIKELY(ch != BAD_MAPPING)) {
-			ptr = index_unpack_ptr(node, ch);
-#if defined(PACKED_INDEX)
-			index32 = ((uint32_t)ptr->hi8 << 16) | ptr->lo16;
-#else
-			index32 = ptr->lo32;
-#endif
-			node = index32 ? &node_heap[index32] : NULL;
-			word++;
-		} else {
-			return true;
-		}
-	}
-}
-
-static inline int read_dictionary(const char *dictfile)
+	register const size_t len)
 {
-	int fd;
-	char *ptr, *dict, *dict_end;
-	struct stat buf;
-	char buffer[4096];
-	const char *buffer_end = buffer + (sizeof(buffer)) - 1;
-
-	fd = open(dictfile, O_RDONLY);
-	if (fd < 0) {
-		(void)snprintf(buffer, sizeof(buffer), "/snap/kernelscan/current/%s", dictfile);
-		fd = open(buffer, O_RDONLY);
-		if (fd < 0)
-			return -1;
-	}
-	if (fstat(fd, &buf) < 0) {
-		(void)close(fd);
-		return -1;
-	}
+	register uint32_t hash;
+	register const printk_name_t *name;
 
-	ptr = dict = mmap(NULL, buf.st_size, PROT_READ, MAP_SHARED | MAP_POPULATE, fd, 0);
-	if (dict == MAP_FAILED) {
-		(void)close(fd);
-		return -1;
-	}
-	dict_end = dict + buf.st_size;
-
-	while (ptr < dict_end) {
-		char *bptr = buffer;
+	if (LIKELY((len >= 64) || !(printk_lengths & (1ULL << len))))
+		return false;
+	if (LIKELY(len > 1) &&
+	    !(printk_bigrams[(uint8_t)word[0]] & (1ULL << (word[1] & 63))))
+		return false;
 
-		while (ptr < dict_end && bptr < buffer_end && *ptr != '\n') {
-			*bptr++ = *ptr++;
-		}
-		dict_size += bptr - buffer;
-		*bptr = '\0';
-		ptr++;
-		words++;
-		add_word(buffer, word_nodes, word_node_heap, &word_node_heap_next, WORD_NODES_HEAP_SIZE);
-	}
-	(void)munmap(dict, buf.st_size);
-	(void)close(fd);
+	hash = word_hash(word, len);
+	name = &printk_names[printk_hash_slot(hash,
+		printk_hash_disp[hash >> (32 - PRINTK_HASH_BITS)])];
 
-	return 0;
+	return (name->len == len) && !__builtin_memcmp(name->name, word, len);
 }
 
-static inline void HOT add_bad_spelling(const char *word, const size_t len)
+static int printk_word_cmp(const void *p1, const void *p2)
 {
-	register hash_entry_t **head, *he;
-
-	if (find_word(word, printk_nodes, printk_node_heap))
-		return;
-
-	bad_spellings_total++;
-	head = &hash_bad_spellings[djb2a(word)];
-	for (he = *head; he; he = he ->next) {
-		if (!__builtin_strcmp(he->token, word))
-			return;
-	}
-	he = malloc(sizeof(*he) + len);
-	if (UNLIKELY(!he))
-		out_of_memory();
-
-	he->next = *head;
-	*head = he;
-	__builtin_memcpy(he->token, word, len);
-	bad_spellings++;
+	return strcmp((const char *)p1, *(const char *const *)p2);
 }
 
-static void TARGET_CLONES HOT check_words(token_t *token)
+/*
+ *  Check if a word, ignoring case, is a printk like function
+ *  name, only names of letters only can match a word
+ */
+static bool printk_word_find(
+	register const char *RESTRICT word,
+	register const size_t len)
 {
-	register char *p1 = token->token, *p2, *p3;
-
-	p3 = p1 + token_len(token);
+	char buf[64];
+	register size_t i;
 
-	while (p1 < p3) {
-		/* skip non-alhabetics */
-		while (*p1 && !isalpha(*p1))
-			p1++;
-		if (!*p1)
-			return;
-		p2 = p1;
-		//while (LIKELY((*p2 && (isalnum(*p2) || *p2 == '_'))))
-		while (LIKELY((*p2 && (isalpha(*p2)))))
-			p2++;
-		*p2 = '\0';
+	if (len >= sizeof(buf))
+		return false;
+	for (i = 0; i < len; i++)
+		buf[i] = tolower((unsigned char)word[i]);
+	buf[len] = '\0';
 
-		if (LIKELY(p2 - p1 > 1)) {
-			if (!find_word(p1, word_nodes, word_node_heap))
-				add_bad_spelling(p1, 1 + p2 - p1);
-		}
-		p1 = p2 + 1;
-	}
-	return;
+	return bsearch(buf, printk_words, PRINTK_WORDS_SIZE,
+		sizeof(printk_words[0]), printk_word_cmp) != NULL;
 }
 
 /*
@@ -2824,660 +883,2308 @@ static double gettime_to_double(void)
 }
 
 /*
- *  Initialise the parser
+ *  Count the bits in a 32 bit value, without popcnt the
+ *  builtin is a libgcc call which is too slow for the
+ *  DAWG lookups
  */
-static inline HOT void parser_new(
-	parser_t *RESTRICT p,
-	unsigned char *RESTRICT data,
-	unsigned char *RESTRICT data_end,
-	const bool skip_white_space)
+static inline uint32_t popcount32(register uint32_t x)
 {
-	p->data = data;
-	p->data_end = data_end;
-	p->ptr = data;
-	p->skip_white_space = skip_white_space;
+#if defined(__POPCNT__)
+	return __builtin_popcount(x);
+#else
+	x = x - ((x >> 1) & 0x55555555);
+	x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+	return (((x + (x >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24;
+#endif
 }
 
 /*
- *  Get next character from input stream
+ *  Find a word in the dictionary DAWG, a character that
+ *  can't be mapped terminates the search
+ *  and counts as a match. Callers built for popcnt set
+ *  hw_popcount to count edges with the popcnt instruction
  */
-static inline get_char_t HOT get_char(register parser_t *p)
+static inline ALWAYS_INLINE bool HOT dawg_find_word(
+	register const char *RESTRICT word,
+	register size_t len,
+	const bool hw_popcount)
 {
-	if (LIKELY(p->ptr < p->data_end)) {
-		return *(p->ptr++);
-	} else
-		return PARSER_EOF;
+	register const dawg_node_t *RESTRICT nodes = dawg_nodes;
+	register const dawg_node_t *RESTRICT node = nodes + dawg_root;
+
+	for (; len; word++, len--) {
+		register get_char_t ch = map((unsigned char)*word);
+		register uint32_t bit;
+
+		if (UNLIKELY(ch == BAD_MAPPING))
+			return true;
+		bit = 1U << ch;
+		if (!(node->labels & bit))
+			return false;
+		bit = node->labels & (bit - 1);
+		node = nodes + dawg_edges[node->edge +
+			(hw_popcount ? (uint32_t)__builtin_popcount(bit) : popcount32(bit))];
+	}
+	return !!(node->labels & DAWG_EOW);
 }
 
-/*
- *  Push character back onto the input
- *  stream (in this case, it is a simple FIFO stack
- */
-static inline void HOT unget_char(parser_t *p)
+static bool HOT dict_find_word_generic(const char *RESTRICT word, size_t len)
 {
-	//if (LIKELY(p->ptr > p->data))
-	p->ptr--;
+	return dawg_find_word(word, len, false);
 }
 
-static int HOT CONST PURE cmp_format(const void *RESTRICT p1, const void *RESTRICT p2)
+#if defined(HAVE_SCAN_X86)
+static bool HOT TARGET_POPCNT dict_find_word_popcnt(const char *RESTRICT word, size_t len)
 {
-	const format_t *RESTRICT f1 = (const format_t *RESTRICT )p1;
-	const format_t *RESTRICT f2 = (const format_t *RESTRICT )p2;
+	return dawg_find_word(word, len, true);
+}
+#endif
 
-	register const size_t l1 = f1->len;
-	register const size_t l2 = f2->len;
+static inline uint32_t dawg_hash(
+	const uint32_t labels,
+	const uint32_t *RESTRICT targets,
+	const uint32_t n_edges)
+{
+	register uint32_t i, hash = labels * 0x9e3779b9;
 
-	if (l1 < l2)
-		return 1;
-	if (l1 > l2)
-		return -1;
-	return strcmp(f1->format, f2->format);
+	for (i = 0; i < n_edges; i++)
+		hash = (hash ^ targets[i]) * 0x01000193;
+
+	return hash ^ (hash >> 15);
 }
 
 /*
- *  Clear the token ready for re-use
+ *  Double the DAWG register and rehash the nodes in it
  */
-static inline void HOT token_clear(token_t *t)
+static void dawg_rehash(dawg_builder_t *RESTRICT b)
 {
-	t->ptr = t->token;
-	t->token_end = t->token + t->len;
-	t->type = TOKEN_UNKNOWN;
-	*(t->ptr) = '\0';
+	const uint32_t hash_size = b->hash_size ? b->hash_size << 1 : 4096;
+	uint32_t *hash = calloc(hash_size, sizeof(*hash));
+	uint32_t node;
+
+	if (UNLIKELY(!hash))
+		out_of_memory();
+
+	for (node = 0; node < b->n_nodes; node++) {
+		const dawg_node_t *n = &b->nodes[node];
+		register uint32_t h = dawg_hash(n->labels, b->edges + n->edge,
+			popcount32(n->labels & DAWG_LABELS)) & (hash_size - 1);
+
+		while (hash[h])
+			h = (h + 1) & (hash_size - 1);
+		hash[h] = node + 1;
+	}
+	free(b->hash);
+	b->hash = hash;
+	b->hash_size = hash_size;
 }
 
 /*
- *  Create a new token, give it plenty of slop so
- *  we don't need to keep on reallocating the token
- *  buffer as we append more characters to it during
- *  the lexing phase.
+ *  Freeze a state, returning an existing identical node
+ *  from the register or emitting a new one
  */
-static void token_new(token_t *t)
+static uint32_t dawg_freeze(
+	dawg_builder_t *RESTRICT b,
+	const dawg_state_t *RESTRICT state)
 {
-	int ret;
+	const size_t targets_size = state->n_edges * sizeof(*state->targets);
+	register uint32_t h, node;
 
-	ret = posix_memalign((void **)&t->token, 64, TOKEN_CHUNK_SIZE);
-	if (ret != 0)
-		out_of_memory();
-	t->len = TOKEN_CHUNK_SIZE;
-	token_clear(t);
+	if (b->n_nodes >= b->hash_size >> 1)
+		dawg_rehash(b);
+
+	for (h = dawg_hash(state->labels, state->targets, state->n_edges) & (b->hash_size - 1);
+	     b->hash[h]; h = (h + 1) & (b->hash_size - 1)) {
+		const dawg_node_t *n = &b->nodes[b->hash[h] - 1];
+
+		/* same labels implies the same number of edges */
+		if ((n->labels == state->labels) &&
+		    !__builtin_memcmp(b->edges + n->edge, state->targets, targets_size))
+			return b->hash[h] - 1;
+	}
+
+	if (b->n_nodes >= b->nodes_size) {
+		dawg_node_t *nodes;
+
+		b->nodes_size = b->nodes_size ? b->nodes_size << 1 : 4096;
+		nodes = realloc(b->nodes, b->nodes_size * sizeof(*nodes));
+		if (UNLIKELY(!nodes))
+			out_of_memory();
+		b->nodes = nodes;
+	}
+	if (b->n_edges + state->n_edges > b->edges_size) {
+		uint32_t *edges;
+
+		b->edges_size = b->edges_size ? b->edges_size << 1 : 4096;
+		edges = realloc(b->edges, b->edges_size * sizeof(*edges));
+		if (UNLIKELY(!edges))
+			out_of_memory();
+		b->edges = edges;
+	}
+
+	node = b->n_nodes++;
+	b->nodes[node].labels = state->labels;
+	b->nodes[node].edge = b->n_edges;
+	__builtin_memcpy(b->edges + b->n_edges, state->targets, targets_size);
+	b->n_edges += state->n_edges;
+	b->hash[h] = node + 1;
+
+	return node;
 }
 
 /*
- *  Free the token
+ *  Freeze the states on the path from depth down to
+ *  (but not including) prefix, linking each one to the
+ *  last edge of its parent
  */
-static void token_free(token_t *t)
+static void dawg_freeze_path(
+	dawg_builder_t *RESTRICT b,
+	dawg_state_t *RESTRICT path,
+	size_t depth,
+	const size_t prefix)
 {
-	free(t->token);
-	t->ptr = NULL;
-	t->token = NULL;
-	t->token_end = NULL;
-	t->len = 0;
+	for (; depth > prefix; depth--) {
+		dawg_state_t *parent = &path[depth - 1];
+
+		parent->targets[parent->n_edges - 1] = dawg_freeze(b, &path[depth]);
+	}
 }
 
-static void HOT token_expand(token_t *t)
+static int dawg_key_cmp(const void *p1, const void *p2)
 {
-	/* No more space, add more space */
-	ptrdiff_t diff = t->ptr - t->token;
+	const uint64_t k1 = *(const uint64_t *)p1;
+	const uint64_t k2 = *(const uint64_t *)p2;
 
-	t->len += TOKEN_CHUNK_SIZE;
-	t->token_end += TOKEN_CHUNK_SIZE;
-	t->token = realloc(t->token, t->len);
-	if (UNLIKELY(!t->token))
-		out_of_memory();
-	t->ptr = t->token + diff;
+	return (k1 > k2) - (k1 < k2);
 }
 
 /*
- *  Append a single character to the token
+ *  Copy the built DAWG into its final layout. The top levels are
+ *  laid out breadth first and, within each level, by the number
+ *  of dictionary prefixes through each node, so the hot nodes
+ *  near the root share cache lines. The builder emits the nodes
+ *  of a path together, leaves first, so the remaining nodes keep
+ *  that order reversed and a lookup walks forwards through
+ *  memory. A fully breadth first layout scatters every path
+ *  over the levels and is slower once past the top. Nodes and
+ *  edges go in one huge page aligned block to keep the TLB
+ *  footprint down.
  */
-static inline void HOT token_append(register token_t *t, register const get_char_t ch)
+static void dawg_relayout(dawg_builder_t *RESTRICT b, const uint32_t root)
 {
-	if (LIKELY(t->ptr < (t->token_end))) {
-		*(t->ptr++) = ch;
-	} else {
-		token_expand(t);
-		*(t->ptr++) = ch;
+	const uint32_t n_nodes = b->n_nodes;
+	const size_t nodes_size = (size_t)n_nodes * sizeof(*dawg_nodes);
+	const size_t size = nodes_size + (size_t)b->n_edges * sizeof(*dawg_edges);
+	uint64_t *order;	/* ~prefixes << 32 | old node, by new node */
+	uint32_t *prefixes;	/* prefixes through each old node */
+	uint32_t *renumber;	/* new node for each old node */
+	uint32_t i, n, head, tail, level_end, edge;
+	void *block;
+
+	order = malloc(n_nodes * sizeof(*order));
+	prefixes = calloc(n_nodes, sizeof(*prefixes));
+	renumber = malloc(n_nodes * sizeof(*renumber));
+	if (UNLIKELY(!order || !prefixes || !renumber))
+		out_of_memory();
+
+	/* children are always emitted before their parents */
+	prefixes[root] = 1;
+	for (n = n_nodes; n--; ) {
+		const dawg_node_t *node = &b->nodes[n];
+		const uint32_t *e = b->edges + node->edge;
+		const uint32_t *e_end = e + popcount32(node->labels & DAWG_LABELS);
+
+		for (; e < e_end; e++)
+			prefixes[*e] += prefixes[n];
 	}
-}
 
-static inline void HOT token_eos(token_t *t)
-{
-	*(t->ptr) = '\0';
-}
+	(void)__builtin_memset(renumber, 0xff, n_nodes * sizeof(*renumber));
+	renumber[root] = 0;
+	order[0] = root;
+	for (head = 0, tail = 1; head < tail; head = level_end) {
+		for (level_end = tail; head < level_end; head++) {
+			const dawg_node_t *node = &b->nodes[order[head] & 0xffffffff];
+			const uint32_t *e = b->edges + node->edge;
+			const uint32_t *e_end = e + popcount32(node->labels & DAWG_LABELS);
+
+			for (; e < e_end; e++) {
+				if (renumber[*e] == ~0U) {
+					renumber[*e] = 0;
+					order[tail++] = ((uint64_t)~prefixes[*e] << 32) | *e;
+				}
+			}
+		}
+		qsort(order + level_end, tail - level_end, sizeof(*order), dawg_key_cmp);
+		for (i = level_end; i < tail; i++)
+			renumber[order[i] & 0xffffffff] = i;
+		if (tail >= DAWG_HOT_NODES)
+			break;
+	}
 
-static inline void HOT token_cat_str(register token_t *RESTRICT t, register const char *RESTRICT str)
-{
-	while (*str) {
-		token_append(t, *str);
-		str++;
+	/* the rest go parents first, keeping each path together */
+	for (n = n_nodes; n--; ) {
+		if (renumber[n] == ~0U) {
+			renumber[n] = tail;
+			order[tail++] = n;
+		}
 	}
-	token_eos(t);
+
+	if (posix_memalign(&block, DAWG_HUGE_PAGE_SIZE,
+	    (size + DAWG_HUGE_PAGE_SIZE - 1) & ~(size_t)(DAWG_HUGE_PAGE_SIZE - 1)))
+		out_of_memory();
+#if defined(MADV_HUGEPAGE)
+	(void)madvise(block, size, MADV_HUGEPAGE);
+#endif
+	dawg_nodes = (dawg_node_t *)block;
+	dawg_edges = (uint32_t *)((char *)block + nodes_size);
+
+	for (n = 0, edge = 0; n < tail; n++) {
+		const dawg_node_t *node = &b->nodes[order[n] & 0xffffffff];
+		const uint32_t *e = b->edges + node->edge;
+		const uint32_t *e_end = e + popcount32(node->labels & DAWG_LABELS);
+
+		dawg_nodes[n].labels = node->labels;
+		dawg_nodes[n].edge = edge;
+		for (; e < e_end; e++)
+			dawg_edges[edge++] = renumber[*e];
+	}
+	dawg_root = 0;
+	dawg_node_count = tail;
+	dawg_edge_count = edge;
+
+	free(renumber);
+	free(prefixes);
+	free(order);
 }
 
-static get_char_t HOT skip_macros(register parser_t *p)
+static int dawg_word_cmp(const void *p1, const void *p2)
 {
-	bool continuation = false;
-
-	for (;;) {
-		register get_char_t ch;
+	const dawg_word_t *w1 = (const dawg_word_t *)p1;
+	const dawg_word_t *w2 = (const dawg_word_t *)p2;
+	const uint32_t len = w1->len < w2->len ? w1->len : w2->len;
+	const int ret = __builtin_memcmp(w1->word, w2->word, len);
 
-		ch = get_char(p);
-		if (ch == '\n') {
-			lines++;
-			lineno++;
-			if (!continuation)
-				return ch;
-			continuation = false;
-		} else if (ch == '\\') {
-			continuation = true;
-		} else if (UNLIKELY(ch == PARSER_EOF))
-			break;
-	}
-	return PARSER_EOF;
+	if (ret)
+		return ret;
+	return (w1->len > w2->len) - (w1->len < w2->len);
 }
 
 /*
- *  Parse C comments and just throw them away
+ *  Build a minimized DAWG from the words using incremental
+ *  construction from sorted data (Daciuk et al.), states
+ *  that are no longer on the path of the most recent word
+ *  can never change again and are frozen straight away
  */
-static get_char_t HOT TARGET_CLONES skip_comments(parser_t *p)
+static void dawg_build(
+	dawg_word_t *RESTRICT dawg_words,
+	const size_t n_words,
+	const size_t max_len)
 {
-	register get_char_t ch, nextch;
+	dawg_builder_t b;
+	dawg_state_t *path;
+	const uint8_t *prev = NULL;
+	size_t i, depth = 0, prev_len = 0;
+
+	(void)__builtin_memset(&b, 0, sizeof(b));
+	path = calloc(max_len + 1, sizeof(*path));
+	if (UNLIKELY(!path))
+		out_of_memory();
 
-	nextch = get_char(p);
+	qsort(dawg_words, n_words, sizeof(*dawg_words), dawg_word_cmp);
 
-	if (nextch == '/') {
-		do {
-			ch = get_char(p);
-			if (UNLIKELY(ch == PARSER_EOF))
-				return ch;
-		} while (ch != '\n');
+	for (i = 0; i < n_words; i++) {
+		const uint8_t *word = dawg_words[i].word;
+		const size_t len = dawg_words[i].len;
+		size_t prefix = 0, j;
 
-		return PARSER_COMMENT_FOUND;
+		while ((prefix < len) && (prefix < prev_len) && (word[prefix] == prev[prefix]))
+			prefix++;
+		if (prev && (prefix == len) && (len == prev_len))
+			continue;	/* duplicate */
+
+		dawg_freeze_path(&b, path, depth, prefix);
+		for (j = prefix; j < len; j++) {
+			path[j].labels |= 1U << word[j];
+			path[j].targets[path[j].n_edges++] = 0;
+			path[j + 1].labels = 0;
+			path[j + 1].n_edges = 0;
+		}
+		path[len].labels |= DAWG_EOW;
+		depth = len;
+		prev = word;
+		prev_len = len;
 	}
+	dawg_freeze_path(&b, path, depth, 0);
+	dawg_relayout(&b, dawg_freeze(&b, &path[0]));
 
-	if (LIKELY(nextch == '*')) {
-		for (;;) {
-			ch = get_char(p);
+	free(path);
+	free(b.hash);
+	free(b.nodes);
+	free(b.edges);
+}
 
-			if (UNLIKELY(ch == '*')) {
-				ch = get_char(p);
+/*
+ *  Look up every dictionary word to measure DAWG
+ *  lookup throughput
+ */
+static void dawg_lookup_benchmark(const char *dict, const char *dict_end)
+{
+	const char *ptr;
+	uint32_t lookups = 0, found = 0;
+	double t1, t2;
 
-				if (LIKELY(ch == '/'))
-					return PARSER_COMMENT_FOUND;
-				else if (UNLIKELY(ch == PARSER_EOF))
-					return ch;
+	t1 = gettime_to_double();
+	for (ptr = dict; ptr < dict_end; ptr++) {
+		const char *word = ptr;
 
-				unget_char(p);
-			}
-			if (UNLIKELY(ch == PARSER_EOF))
-				return ch;
-		}
+		while ((ptr < dict_end) && (*ptr != '\n'))
+			ptr++;
+		found += dict_find_word(word, ptr - word);
+		lookups++;
 	}
-	if (UNLIKELY(nextch == PARSER_EOF))
-		return nextch;
+	t2 = gettime_to_double();
 
-	/* Not a comment, push back */
-	unget_char(p);
+	/* keep the lookups from being optimized away */
+	__asm__ __volatile__("" : : "r"(found));
+	dawg_lookup_rate = FLOAT_CMP(t1, t2) ? 0.0 : (double)lookups / (t2 - t1);
+}
 
-	return PARSER_OK;
+static inline size_t dawg_size(void)
+{
+	return (size_t)dawg_node_count * sizeof(*dawg_nodes) +
+	       (size_t)dawg_edge_count * sizeof(*dawg_edges);
 }
 
 /*
- *  Parse an integer.  This is fairly minimal as the
- *  kernel doesn't have floats or doubles, so we
- *  can just parse decimal, octal or hex values.
+ *  Walking words in lockstep only pays off once the DAWG no
+ *  longer fits in the L2 cache, below that the bookkeeping
+ *  and branch misses cost more than the overlapped misses
  */
-static get_char_t HOT TARGET_CLONES parse_number(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+static void set_dict_lanes(void)
 {
-	bool ishex = false;
-	bool isoct = false;
+	size_t cache_size = DICT_LANES_CACHE_SIZE;
+#if defined(_SC_LEVEL2_CACHE_SIZE)
+	const long ret = sysconf(_SC_LEVEL2_CACHE_SIZE);
 
-	/*
-	 *  Crude way to detect the kind of integer
-	 */
-	if (LIKELY(ch == '0')) {
-		register get_char_t nextch1, nextch2;
+	if (ret > 0)
+		cache_size = (size_t)ret;
+#endif
+	dict_lanes = (dawg_size() > cache_size) ? DICT_LANES : 1;
+}
 
-		token_append(t, ch);
+/*
+ *  Use a mapped precompiled dictionary image, it is checked
+ *  before use so a truncated or corrupt image can't make the
+ *  lookups stray outside of it
+ */
+static int dict_image_map(const char *dictfile, char *image, const size_t size)
+{
+	const dict_image_t *hdr = (const dict_image_t *)image;
+	dawg_node_t *nodes = (dawg_node_t *)(image + sizeof(*hdr));
+	uint32_t *edges;
+	uint32_t i;
 
-		nextch1 = get_char(p);
+	if (hdr->endian != DICT_IMAGE_ENDIAN) {
+		fprintf(stderr, "Dictionary image %s has the wrong byte order\n", dictfile);
+		return -1;
+	}
+	if (hdr->version != DICT_IMAGE_VERSION) {
+		fprintf(stderr, "Dictionary image %s is version %" PRIu32
+			", expected version %d\n", dictfile, hdr->version, DICT_IMAGE_VERSION);
+		return -1;
+	}
+	if ((hdr->root >= hdr->n_nodes) ||
+	    (size != sizeof(*hdr) + (size_t)hdr->n_nodes * sizeof(*nodes) +
+		     (size_t)hdr->n_edges * sizeof(*edges)))
+		goto corrupt;
+
+	edges = (uint32_t *)(nodes + hdr->n_nodes);
+	for (i = 0; i < hdr->n_nodes; i++) {
+		const uint32_t n_edges = popcount32(nodes[i].labels & DAWG_LABELS);
+
+		if ((nodes[i].labels & ~(DAWG_EOW | DAWG_LABELS)) ||
+		    (nodes[i].edge > hdr->n_edges) ||
+		    (n_edges > hdr->n_edges - nodes[i].edge))
+			goto corrupt;
+	}
+	for (i = 0; i < hdr->n_edges; i++) {
+		if (edges[i] >= hdr->n_nodes)
+			goto corrupt;
+	}
 
-		if (nextch1 >= '0' && nextch1 <= '8') {
-			/* Must be an octal value */
-			ch = nextch1;
-			isoct = true;
-		} else if (nextch1 == 'x' || nextch1 == 'X') {
-			/* Is it hexadecimal? */
-			nextch2 = get_char(p);
+#if defined(MADV_HUGEPAGE)
+	/* only honoured where file backed THPs are supported */
+	(void)madvise(image, size, MADV_HUGEPAGE);
+#endif
+	dawg_nodes = nodes;
+	dawg_edges = edges;
+	dawg_root = hdr->root;
+	dawg_node_count = hdr->n_nodes;
+	dawg_edge_count = hdr->n_edges;
+	words = hdr->words;
+	dict_size = hdr->dict_size;
 
-			if (isxdigit(nextch2)) {
-				/* Hexadecimal */
-				token_append(t, nextch1);
-				ch = nextch2;
-				ishex = true;
-			} else if (LIKELY(nextch2 != PARSER_EOF)) {
-				/* Nope */
-				unget_char(p);
-				unget_char(p);
-				token_eos(t);
-				return PARSER_OK;
-			} else {
-				unget_char(p);
-				token_eos(t);
-				return PARSER_OK;
-			}
-		} else if (LIKELY(nextch1 != PARSER_EOF)) {
-			unget_char(p);
-			token_eos(t);
-			return PARSER_OK;
-		} else {
-			token_append(t, ch);
-			token_eos(t);
-			return PARSER_OK;
-		}
+	return 0;
+
+corrupt:
+	fprintf(stderr, "Dictionary image %s is corrupt\n", dictfile);
+	return -1;
+}
+
+static inline int read_dictionary(const char *dictfile)
+{
+	int fd;
+	char *ptr, *dict, *dict_end;
+	struct stat buf;
+	char buffer[4096];
+	uint8_t *mapped;
+	dawg_word_t *dawg_words = NULL;
+	size_t n_words = 0, dawg_words_size = 0, max_len = 0, n_mapped = 0;
+
+	fd = open(dictfile, O_RDONLY);
+	if (fd < 0) {
+		(void)snprintf(buffer, sizeof(buffer), "/snap/kernelscan/current/%s", dictfile);
+		fd = open(buffer, O_RDONLY);
+		if (fd < 0)
+			return -1;
+	}
+	if (fstat(fd, &buf) < 0) {
+		(void)close(fd);
+		return -1;
 	}
 
-	/*
-	 * OK, we now know what type of integer we
-	 * are processing, so just gather up the digits
-	 */
-	token_append(t, ch);
+	ptr = dict = mmap(NULL, buf.st_size, PROT_READ, MAP_SHARED | MAP_POPULATE, fd, 0);
+	if (dict == MAP_FAILED) {
+		(void)close(fd);
+		return -1;
+	}
+	dict_end = dict + buf.st_size;
 
-	for (;;) {
-		ch = get_char(p);
+	if (((size_t)buf.st_size >= sizeof(dict_image_t)) &&
+	    !__builtin_memcmp(dict, DICT_IMAGE_MAGIC, sizeof(DICT_IMAGE_MAGIC))) {
+		/* the DAWG is used in place, so keep the image mapped */
+		if (dict_image_map(dictfile, dict, (size_t)buf.st_size) < 0) {
+			(void)munmap(dict, buf.st_size);
+			(void)close(fd);
+			return -2;
+		}
+		(void)close(fd);
+		return 0;
+	}
 
-		if (UNLIKELY(ch == PARSER_EOF)) {
-			unget_char(p);
-			token_eos(t);
-			return PARSER_OK;
+	/* mapped words are never longer than the dictionary */
+	mapped = malloc(buf.st_size + 1);
+	if (UNLIKELY(!mapped))
+		out_of_memory();
+
+	while (ptr < dict_end) {
+		const char *line = ptr;
+		const char *line_end = ptr + sizeof(buffer) - 1;
+		uint8_t *word = mapped + n_mapped;
+		get_char_t ch = 0;
+
+		if (line_end > dict_end)
+			line_end = dict_end;
+		while (ptr < line_end && *ptr != '\n')
+			ptr++;
+		dict_size += ptr - line;
+
+		/* the word is the mapped prefix of the line */
+		for (; line < ptr; line++) {
+			ch = map((unsigned char)*line);
+			if (ch == BAD_MAPPING)
+				break;
+			mapped[n_mapped++] = ch;
 		}
+		ptr++;
+		words++;
 
-		if (ishex) {
-			if (LIKELY(isxdigit(ch))) {
-				token_append(t, ch);
-			} else {
-				unget_char(p);
-				token_eos(t);
-				return PARSER_OK;
-			}
-		} else if (isoct) {
-			if (LIKELY(ch >= '0' && ch <= '8')) {
-				token_append(t, ch);
-			} else {
-				unget_char(p);
-				token_eos(t);
-				return PARSER_OK;
-			}
-		} else {
-			if (isdigit(ch)) {
-				token_append(t, ch);
-			} else {
-				unget_char(p);
-				token_eos(t);
-				return PARSER_OK;
-			}
+		if (n_words >= dawg_words_size) {
+			dawg_word_t *tmp;
+
+			dawg_words_size = dawg_words_size ? dawg_words_size << 1 : 4096;
+			tmp = realloc(dawg_words, dawg_words_size * sizeof(*dawg_words));
+			if (UNLIKELY(!tmp))
+				out_of_memory();
+			dawg_words = tmp;
 		}
+		dawg_words[n_words].word = word;
+		dawg_words[n_words].len = (mapped + n_mapped) - word;
+		if (dawg_words[n_words].len > max_len)
+			max_len = dawg_words[n_words].len;
+		n_words++;
 	}
+
+	dawg_build(dawg_words, n_words, max_len);
+	free(dawg_words);
+	free(mapped);
+
+	if (dict_benchmark)
+		dawg_lookup_benchmark(dict, dict_end);
+
+	(void)munmap(dict, buf.st_size);
+	(void)close(fd);
+
+	return 0;
 }
 
 /*
- *  Parse identifiers
+ *  Write all of a buffer, retrying short writes
  */
-static get_char_t HOT parse_identifier(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+static int write_all(const int fd, const void *buf, size_t len)
 {
-	t->type = TOKEN_IDENTIFIER;
-	token_append(t, ch);
+	const char *ptr = (const char *)buf;
 
-	for (;;) {
-		ch = get_char(p);
-		register uint8_t ch8 = (uint8_t)ch;
+	while (len) {
+		const ssize_t ret = write(fd, ptr, len);
 
-		if (UNLIKELY(is_not_identifier[ch8])) {
-			unget_char(p);
-			token_eos(t);
-			return PARSER_OK;
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			return -1;
 		}
-		token_append(t, ch);
+		ptr += ret;
+		len -= (size_t)ret;
 	}
+	return 0;
 }
 
 /*
- *  Handle escape char deletion when at the end of a literal string,
- *  need to transform:
- * 	"foo\n" -> "foo" 
- * 	"foo\nbar" -> "foo bar"
- *	"foo\n"<whitespaces>"bar" -> "foo "<whitespaces>"bar"
+ *  Compile a dictionary into a dictionary image. The image is
+ *  written to a temporary file and renamed into place so that
+ *  processes already mapping the old image are not disturbed
  */
-static inline void literal_peek(
-	parser_t *RESTRICT p,
-	token_t *RESTRICT t,
-	const get_char_t literal)
+static int compile_dictionary(const char *dictfile, const char *imagefile)
 {
-	register get_char_t ch;
-	uint32_t got;
+	dict_image_t hdr;
+	char tmpfile[PATH_MAX];
+	int fd, ret;
+
+	ret = read_dictionary(dictfile);
+	if (ret) {
+		if (ret == -1)
+			fprintf(stderr, "No dictionary found, expecting words in %s\n", dictfile);
+		return -1;
+	}
 
-	ch = get_char(p);
-	if (UNLIKELY(ch != literal)) {
-		unget_char(p);
-		token_append(t, ' ');
-		return;
+	(void)__builtin_memset(&hdr, 0, sizeof(hdr));
+	(void)__builtin_memcpy(hdr.magic, DICT_IMAGE_MAGIC, sizeof(DICT_IMAGE_MAGIC));
+	hdr.version = DICT_IMAGE_VERSION;
+	hdr.endian = DICT_IMAGE_ENDIAN;
+	hdr.words = words;
+	hdr.dict_size = dict_size;
+	hdr.root = dawg_root;
+	hdr.n_nodes = dawg_node_count;
+	hdr.n_edges = dawg_edge_count;
+
+	if ((size_t)snprintf(tmpfile, sizeof(tmpfile), "%s.XXXXXX", imagefile) >= sizeof(tmpfile)) {
+		fprintf(stderr, "Dictionary image path %s is too long\n", imagefile);
+		return -1;
 	}
-	got = 1;
-	for (;;) {
-		got++;
-		ch = get_char(p);
-		if (LIKELY(ch == literal)) {
-			token_append(t, ' ');
-			break;
-		} else if (UNLIKELY(ch == TOKEN_WHITE_SPACE)) {
-			continue;
-		} else if (UNLIKELY(ch == PARSER_EOF)) {
-			break;
-		}
-		break;
+	fd = mkstemp(tmpfile);
+	if (fd < 0) {
+		fprintf(stderr, "Cannot create %s, errno=%d (%s)\n",
+			tmpfile, errno, strerror(errno));
+		return -1;
+	}
+	if ((fchmod(fd, 0644) < 0) ||
+	    (write_all(fd, &hdr, sizeof(hdr)) < 0) ||
+	    (write_all(fd, dawg_nodes, (size_t)dawg_node_count * sizeof(*dawg_nodes)) < 0) ||
+	    (write_all(fd, dawg_edges, (size_t)dawg_edge_count * sizeof(*dawg_edges)) < 0)) {
+		fprintf(stderr, "Cannot write %s, errno=%d (%s)\n",
+			tmpfile, errno, strerror(errno));
+		(void)close(fd);
+		(void)unlink(tmpfile);
+		return -1;
 	}
-	while (got) {
-		unget_char(p);
-		got--;
+	if (close(fd) < 0) {
+		fprintf(stderr, "Cannot close %s, errno=%d (%s)\n",
+			tmpfile, errno, strerror(errno));
+		(void)unlink(tmpfile);
+		return -1;
+	}
+	if (rename(tmpfile, imagefile) < 0) {
+		fprintf(stderr, "Cannot rename %s to %s, errno=%d (%s)\n",
+			tmpfile, imagefile, errno, strerror(errno));
+		(void)unlink(tmpfile);
+		return -1;
 	}
+
+	printf("%" PRIu32 " words compiled to %zd byte dictionary image %s\n", words,
+		sizeof(hdr) + dawg_size(), imagefile);
+	return 0;
 }
 
 /*
- *  Parse literal strings
+ *  Allocate size bytes from an arena, there is no alignment
+ *  as the arenas just hold strings
  */
-static get_char_t TARGET_CLONES parse_literal(
-	parser_t *RESTRICT p,
-	token_t *RESTRICT t,
-	const get_char_t literal,
-	const token_type_t type)
+static void *arena_alloc(arena_t *RESTRICT arena, const size_t size)
 {
-	t->type = type;
-
-	token_append(t, literal);
-
-	for (;;) {
-		register get_char_t ch = get_char(p);
-
-		if (ch == '\\') {
-			if (opt_flags & OPT_ESCAPE_STRIP) {
-				ch = get_char(p);
-				if (UNLIKELY(ch == PARSER_EOF)) {
-					token_eos(t);
-					return ch;
-				}
-				switch (ch) {
-				case '?':
-					token_append(t, ch);
-					continue;
-				case 'a':
-				case 'b':
-				case 'f':
-				case 'n':
-				case 'r':
-				case 't':
-				case 'v':
-					literal_peek(p, t, literal);
-					continue;
-				case 'x':
-				case '0':
-				case '1':
-				case '2':
-				case '3':
-				case '4':
-				case '5':
-				case '6':
-				case '7':
-				case '9':
-				default:
-					token_append(t, '\\');
-					token_append(t, ch);
-					continue;
-				}
-			} else {
-				token_append(t, ch);
-				ch = get_char(p);
-				if (LIKELY(ch != PARSER_EOF)) {
-					token_append(t, ch);
-					continue;
-				}
-				token_eos(t);
-				return ch;
-			}
-		}
-
-		if (UNLIKELY(ch == literal)) {
-			token_append(t, ch);
-			token_eos(t);
-			return PARSER_OK;
-		}
-		if (UNLIKELY(ch == PARSER_EOF)) {
-			token_eos(t);
-			return PARSER_OK;
+	arena_block_t *block = arena->blocks;
+
+	arena->allocs++;
+	arena->bytes += size;
+	if (UNLIKELY(!block || (block->size - block->used < size))) {
+		const size_t block_size = size > ARENA_LARGE ? size : ARENA_BLOCK_SIZE;
+
+		block = malloc(sizeof(*block) + block_size);
+		if (UNLIKELY(!block))
+			out_of_memory();
+		block->size = block_size;
+		block->used = 0;
+		arena->nblocks++;
+		arena->block_bytes += sizeof(*block) + block_size;
+
+		/* a large block is used up straight away, keep the current one */
+		if ((size > ARENA_LARGE) && arena->blocks) {
+			block->next = arena->blocks->next;
+			arena->blocks->next = block;
+		} else {
+			block->next = arena->blocks;
+			arena->blocks = block;
 		}
-
-		token_append(t, ch);
 	}
-	token_eos(t);
+	block->used += size;
 
-	return PARSER_OK;
+	return block->data + block->used - size;
 }
 
 /*
- *  Parse operators such as +, - which can
- *  be + or ++ forms.
+ *  Copy a string of len chars into an arena, '\0' terminated
  */
-static inline get_char_t parse_op(parser_t *RESTRICT p, token_t *RESTRICT t, const get_char_t op)
+static char *arena_strndup(arena_t *RESTRICT arena, const char *RESTRICT str, const size_t len)
 {
-	token_append(t, op);
+	char *ptr = arena_alloc(arena, len + 1);
 
-	if (get_char(p) == op) {
-		token_append(t, op);
-		token_eos(t);
-		return PARSER_OK;
-	}
+	__builtin_memcpy(ptr, str, len);
+	ptr[len] = '\0';
 
-	unget_char(p);
-	token_eos(t);
-	return PARSER_OK;
+	return ptr;
 }
 
 /*
- *  Parse -, --, ->
+ *  Release everything allocated from an arena, adding its
+ *  counters to the totals reported at exit
  */
-static inline get_char_t parse_minus(parser_t *RESTRICT p, token_t *RESTRICT t, const get_char_t op)
+static void arena_free(arena_t *RESTRICT arena)
 {
-	register get_char_t ch;
-
-	token_append(t, op);
-
-	ch = get_char(p);
+	arena_block_t *block = arena->blocks;
 
-	if (ch == op) {
-		token_append(t, ch);
-		token_eos(t);
-		return PARSER_OK;
-	}
+	while (block) {
+		arena_block_t *next = block->next;
 
-	if (LIKELY(ch == '>')) {
-		token_append(t, ch);
-		token_eos(t);
-		t->type = TOKEN_ARROW;
-		return PARSER_OK;
+		free(block);
+		block = next;
 	}
-
-	unget_char(p);
-	token_eos(t);
-	return PARSER_OK;
+	arena_totals.allocs += arena->allocs;
+	arena_totals.bytes += arena->bytes;
+	arena_totals.nblocks += arena->nblocks;
+	arena_totals.block_bytes += arena->block_bytes;
+	(void)__builtin_memset(arena, 0, sizeof(*arena));
 }
 
-static inline get_char_t parse_skip_comments(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+/*
+ *  Bitmap of the control bytes in the group at ctrl that match
+ */
+static inline uint32_t HOT spelling_group_match(
+	const uint8_t *RESTRICT ctrl,
+	const uint8_t match)
 {
-	get_char_t ret = skip_comments(p);
+#if defined(__SSE2__)
+	const __m128i group = _mm_loadu_si128((const __m128i *)(const void *)ctrl);
 
-	if (ret == PARSER_COMMENT_FOUND) {
-		ret |= PARSER_CONTINUE;
-		return ret;
-	}
-	if (UNLIKELY(ret == PARSER_EOF))
-		return ret;
+	return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)match)));
+#else
+	register uint32_t i, bits = 0;
 
-	token_append(t, ch);
-	token_eos(t);
-	return PARSER_OK;
+	for (i = 0; i < SPELLING_GROUP; i++)
+		bits |= (uint32_t)(ctrl[i] == match) << i;
+	return bits;
+#endif
 }
 
-static inline get_char_t parse_simple(token_t *t, get_char_t ch, const token_type_t type)
+static void spelling_table_alloc(spelling_table_t *RESTRICT t, const uint32_t size)
 {
-	token_append(t, ch);
-	token_eos(t);
-	t->type = type;
-	return PARSER_OK;
+	t->ctrl = malloc(size + SPELLING_GROUP);
+	t->slots = malloc(size * sizeof(*t->slots));
+	if (UNLIKELY(!t->ctrl || !t->slots))
+		out_of_memory();
+	(void)__builtin_memset(t->ctrl, SPELLING_EMPTY, size + SPELLING_GROUP);
+	t->size = size;
+	t->used = 0;
 }
 
-static inline get_char_t parse_hash(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+/*
+ *  Find the empty slot a new word with this hash goes in
+ */
+static inline uint32_t spelling_table_empty(
+	const spelling_table_t *RESTRICT t,
+	const uint32_t hash)
 {
-	(void)p;
-	(void)ch;
+	const uint32_t mask = t->size - 1;
+	register uint32_t pos = (hash >> 7) & mask, stride = 0;
 
-	skip_macros(p);
-	token_clear(t);
+	for (;;) {
+		const uint32_t bits = spelling_group_match(t->ctrl + pos, SPELLING_EMPTY);
 
-	return PARSER_OK;
+		if (bits)
+			return (pos + __builtin_ctz(bits)) & mask;
+		stride += SPELLING_GROUP;
+		pos = (pos + stride) & mask;
+	}
 }
 
-static inline get_char_t parse_paren_opened(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+/*
+ *  Find a word, returning its slot or the empty
+ *  slot it should go in if it is not there
+ */
+static inline uint32_t HOT spelling_table_find(
+	const spelling_table_t *RESTRICT t,
+	const char *RESTRICT word,
+	const size_t len,
+	const uint32_t hash,
+	bool *RESTRICT found)
 {
-	(void)p;
+	const uint32_t mask = t->size - 1;
+	const uint8_t tag = hash & 0x7f;
+	register uint32_t pos = (hash >> 7) & mask, stride = 0;
 
-	return parse_simple(t, ch, TOKEN_PAREN_OPENED);
-}
+	for (;;) {
+		register uint32_t bits = spelling_group_match(t->ctrl + pos, tag);
 
-static inline get_char_t parse_paren_closed(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
-{
-	(void)p;
+		while (bits) {
+			const uint32_t i = (pos + __builtin_ctz(bits)) & mask;
+			const spelling_t *slot = &t->slots[i];
 
-	return parse_simple(t, ch, TOKEN_PAREN_CLOSED);
+			if ((slot->hash == hash) && (slot->len == len) &&
+			    !__builtin_memcmp(slot->word, word, len)) {
+				*found = true;
+				return i;
+			}
+			bits &= bits - 1;
+		}
+		/* nothing is ever removed, so an empty slot ends the probe */
+		if (spelling_group_match(t->ctrl + pos, SPELLING_EMPTY)) {
+			*found = false;
+			return spelling_table_empty(t, hash);
+		}
+		/* triangular steps visit every group of a power of 2 table */
+		stride += SPELLING_GROUP;
+		pos = (pos + stride) & mask;
+	}
 }
 
-
-static inline get_char_t parse_square_opened(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+static inline void spelling_table_set(
+	spelling_table_t *RESTRICT t,
+	const uint32_t i,
+	const spelling_t *RESTRICT spelling)
 {
-	(void)p;
+	const uint8_t tag = spelling->hash & 0x7f;
 
-	return parse_simple(t, ch, TOKEN_SQUARE_OPENED);
+	t->slots[i] = *spelling;
+	t->ctrl[i] = tag;
+	if (i < SPELLING_GROUP)
+		t->ctrl[t->size + i] = tag;
+	t->used++;
 }
 
-static inline get_char_t parse_square_closed(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+/*
+ *  Grow the table so it can hold n words without being
+ *  more than 7/8 full, or allocate it
+ */
+static void spelling_table_reserve(spelling_table_t *RESTRICT t, const uint32_t n)
 {
-	(void)p;
+	spelling_table_t old = *t;
+	uint32_t i, size = old.size ? old.size : SPELLING_TABLE_SIZE;
 
-	return parse_simple(t, ch, TOKEN_SQUARE_CLOSED);
+	while (n > size - (size >> 3))
+		size <<= 1;
+	if (size == old.size)
+		return;
+
+	spelling_table_alloc(t, size);
+	for (i = 0; i < old.size; i++) {
+		if (old.ctrl[i] != SPELLING_EMPTY)
+			spelling_table_set(t, spelling_table_empty(t, old.slots[i].hash), &old.slots[i]);
+	}
+	free(old.ctrl);
+	free(old.slots);
 }
 
-static inline get_char_t parse_less_than(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+/*
+ *  Add a word to the table if it is not already there, the
+ *  word is not copied so it must last as long as the table.
+ *  Returns true if the word was added
+ */
+static inline bool HOT spelling_table_add(
+	spelling_table_t *RESTRICT t,
+	const char *RESTRICT word,
+	const size_t len,
+	const uint32_t hash)
 {
-	(void)p;
+	spelling_t spelling;
+	uint32_t i;
+	bool found;
+
+	if (UNLIKELY(t->used >= t->size - (t->size >> 3)))
+		spelling_table_reserve(t, t->used + 1);
+
+	i = spelling_table_find(t, word, len, hash, &found);
+	if (found)
+		return false;
+
+	spelling.word = word;
+	spelling.len = len;
+	spelling.hash = hash;
+	spelling_table_set(t, i, &spelling);
+	return true;
+}
 
-	return parse_simple(t, ch, TOKEN_LESS_THAN);
+static void spelling_table_free(spelling_table_t *RESTRICT t)
+{
+	free(t->ctrl);
+	free(t->slots);
+	t->ctrl = NULL;
+	t->slots = NULL;
+	t->size = 0;
+	t->used = 0;
 }
 
-static inline get_char_t parse_greater_than(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+/*
+ *  Record a bad spelling, the word is one of the worker's
+ *  unique words so it is already in the worker's arena.
+ *  Words that are printk like names in any case are skipped
+ */
+static inline void HOT add_bad_spelling(
+	worker_t *RESTRICT w,
+	const char *RESTRICT word,
+	const size_t len,
+	const uint32_t hash,
+	const uint32_t count)
 {
-	(void)p;
+	if (printk_word_find(word, len))
+		return;
 
-	return parse_simple(t, ch, TOKEN_GREATER_THAN);
+	w->bad_spellings_total += count;
+	if (spelling_table_add(w->spellings, word, len, hash))
+		w->bad_spellings++;
 }
 
-static inline get_char_t parse_comma(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+/*
+ *  Move a lane one load along its walk through the DAWG, only
+ *  touching the node or edge prefetched on its previous step.
+ *  Returns -1 while walking, otherwise whether the word is in
+ *  the dictionary, with the same rules as dawg_find_word()
+ */
+static inline ALWAYS_INLINE int dawg_lane_step(
+	dict_lane_t *RESTRICT lane,
+	const bool hw_popcount)
 {
-	(void)p;
+	register const dawg_node_t *node;
+	register get_char_t ch;
+	register uint32_t bit;
 
-	return parse_simple(t, ch, TOKEN_COMMA);
+	if (lane->edge) {
+		lane->index = dawg_edges[lane->index];
+		lane->edge = false;
+		__builtin_prefetch(&dawg_nodes[lane->index]);
+		return -1;
+	}
+
+	node = &dawg_nodes[lane->index];
+	if (lane->word == lane->end)
+		return !!(node->labels & DAWG_EOW);
+	ch = map((unsigned char)*lane->word);
+	if (UNLIKELY(ch == BAD_MAPPING))
+		return 1;
+	bit = 1U << ch;
+	if (!(node->labels & bit))
+		return 0;
+	bit = node->labels & (bit - 1);
+	lane->index = node->edge +
+		(hw_popcount ? (uint32_t)__builtin_popcount(bit) : popcount32(bit));
+	lane->edge = true;
+	lane->word++;
+	__builtin_prefetch(&dawg_edges[lane->index]);
+	return -1;
 }
 
-static inline get_char_t parse_terminal(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+/*
+ *  Double the unique word slots, or allocate the first ones
+ */
+static void word_set_grow(word_set_t *RESTRICT set)
 {
-	(void)p;
+	const uint32_t size = set->size ? set->size << 1 : WORD_SET_SIZE;
+	word_count_t *slots = calloc(size, sizeof(*slots));
+	uint32_t i;
 
-	return parse_simple(t, ch, TOKEN_TERMINAL);
+	if (UNLIKELY(!slots))
+		out_of_memory();
+
+	for (i = 0; i < set->size; i++) {
+		register uint32_t h;
+
+		if (!set->slots[i].word)
+			continue;
+		for (h = set->slots[i].hash & (size - 1); slots[h].word; h = (h + 1) & (size - 1))
+			;
+		slots[h] = set->slots[i];
+	}
+	free(set->slots);
+	set->slots = slots;
+	set->size = size;
 }
 
-static inline get_char_t parse_misc_char(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+
+/*
+ *  Count an occurrence of a word, adding it if it is new
+ */
+static inline void HOT word_set_add(
+	word_set_t *RESTRICT set,
+	arena_t *RESTRICT arena,
+	const char *RESTRICT word,
+	const size_t len)
 {
-	(void)p;
+	const uint32_t hash = word_hash(word, len);
+	register word_count_t *slot;
+	register uint32_t h;
 
-	token_append(t, ch);
-	token_eos(t);
-	return PARSER_OK;
+	if (UNLIKELY(set->used >= set->size >> 1))
+		word_set_grow(set);
+
+	for (h = hash & (set->size - 1); ; h = (h + 1) & (set->size - 1)) {
+		slot = &set->slots[h];
+		if (!slot->word)
+			break;
+		if ((slot->hash == hash) && (slot->len == len) &&
+		    !__builtin_memcmp(slot->word, word, len)) {
+			slot->count++;
+			return;
+		}
+	}
+	slot->word = arena_strndup(arena, word, len);
+	slot->len = len;
+	slot->hash = hash;
+	slot->count = 1;
+	set->used++;
 }
 
-static inline get_char_t parse_literal_string(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+/*
+ *  Empty the set, keeping its slots for reuse, the words
+ *  stay in the arena as bad spellings may refer to them
+ */
+static void word_set_clear(word_set_t *RESTRICT set)
 {
-	return parse_literal(p, t, ch, TOKEN_LITERAL_STRING);
+	if (set->used) {
+		(void)__builtin_memset(set->slots, 0, set->size * sizeof(*set->slots));
+		set->used = 0;
+	}
 }
 
-static inline get_char_t parse_literal_char(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+static void word_set_free(word_set_t *RESTRICT set)
 {
-	return parse_literal(p, t, ch, TOKEN_LITERAL_CHAR);
+	word_set_clear(set);
+	free(set->slots);
+	set->slots = NULL;
+	set->size = 0;
 }
 
-static inline get_char_t parse_backslash(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+/*
+ *  Collect the words of two or more letters in a token for
+ *  check_unique_words() to check once the worker is done.
+ *  The token may be a view of the read-only input so the words
+ *  are just delimited by length rather than being terminated
+ *  in place
+ */
+static void HOT check_words(worker_t *RESTRICT w, token_t *RESTRICT token)
 {
-	if (p->skip_white_space)
-		return PARSER_OK | PARSER_CONTINUE;
+	register const char *p1 = token->token, *p2, *p3;
 
-	if (opt_flags & OPT_ESCAPE_STRIP) {
-		token_append(t, ch);
-		token_eos(t);
-		t->type = TOKEN_WHITE_SPACE;
-	} else {
-		token_append(t, ch);
-		ch = get_char(p);
-		if (UNLIKELY(ch == PARSER_EOF))
-			return ch;
-		token_append(t, ch);
-		token_eos(t);
+	p3 = p1 + token_len(token);
+
+	while (p1 < p3) {
+		/* skip non-alhabetics */
+		while ((p1 < p3) && !isalpha(*p1))
+			p1++;
+		if (p1 >= p3)
+			return;
+		p2 = p1;
+		while (LIKELY((p2 < p3) && (isalpha(*p2))))
+			p2++;
+
+		if (LIKELY(p2 - p1 > 1))
+			word_set_add(&w->words, &w->arena, p1, p2 - p1);
+		p1 = p2 + 1;
 	}
-	return PARSER_OK;
 }
 
-static inline get_char_t parse_newline(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+/*
+ *  Start a lane on the next unique word from slot *i,
+ *  returns false if there are no more words
+ */
+static inline ALWAYS_INLINE bool check_unique_words_next(
+	const word_set_t *RESTRICT set,
+	uint32_t *RESTRICT i,
+	dict_lane_t *RESTRICT lane)
 {
-	lines++;
-	lineno++;
-	return parse_backslash(p, t, ch);
-}
+	register const word_count_t *slot;
 
-static inline get_char_t parse_eof(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
-{
-	(void)p;
-	(void)t;
-	(void)ch;
+	for (;;) {
+		if (*i >= set->size)
+			return false;
+		slot = &set->slots[(*i)++];
+		if (slot->word)
+			break;
+	}
 
-	return PARSER_EOF;
+	lane->start = slot->word;
+	lane->word = slot->word;
+	lane->end = slot->word + slot->len;
+	lane->count = slot->count;
+	lane->hash = slot->hash;
+	lane->index = dawg_root;
+	lane->edge = false;
+	return true;
 }
 
-static inline get_char_t TARGET_CLONES parse_whitespace(
-	parser_t *RESTRICT p,
-	token_t *RESTRICT t,
-	const get_char_t ch)
+/*
+ *  Look up each of the worker's unique words in the dictionary
+ *  and record the bad spellings with their occurrence counts.
+ *  Up to n_lanes words are walked through the DAWG in lockstep
+ *  with each step prefetching the next node or edge, so the
+ *  cache misses of the different words overlap; a finished
+ *  lane is refilled with the next word straight away
+ */
+static inline ALWAYS_INLINE void check_unique_words_common(
+	worker_t *RESTRICT w,
+	const bool hw_popcount,
+	const uint32_t n_lanes)
 {
-	(void)p;
+	dict_lane_t lanes[DICT_LANES];
+	const word_set_t *set = &w->words;
+	register uint32_t i, n;
+	uint32_t slot = 0;
 
-	t->type = TOKEN_IDENTIFIER;
-	token_append(t, ch);
+	for (n = 0; (n < n_lanes) && check_unique_words_next(set, &slot, &lanes[n]); n++)
+		;
 
-	for (;;) {
-		register uint8_t ch8;
+	while (n) {
+		for (i = 0; i < n; ) {
+			register dict_lane_t *lane = &lanes[i];
+			register const int ret = dawg_lane_step(lane, hw_popcount);
 
-		ch8 = (uint8_t)get_char(p);
-		if (is_not_whitespace[ch8])
-			break;
+			if (ret < 0) {
+				i++;
+				continue;
+			}
+			if (!ret)
+				add_bad_spelling(w, lane->start, lane->end - lane->start,
+					lane->hash, lane->count);
+			if (check_unique_words_next(set, &slot, lane)) {
+				i++;
+			} else {
+				/* last lane moves here, it has not stepped yet */
+				*lane = lanes[--n];
+			}
+		}
 	}
-	unget_char(p);
-	token_eos(t);
-
-	return parse_simple(t, ' ', TOKEN_WHITE_SPACE);
+}
+
+static void HOT check_unique_words_generic(worker_t *RESTRICT w)
+{
+	check_unique_words_common(w, false, 1);
+}
+
+static void HOT check_unique_words_generic_lanes(worker_t *RESTRICT w)
+{
+	check_unique_words_common(w, false, DICT_LANES);
+}
+
+#if defined(HAVE_SCAN_X86)
+static void HOT TARGET_POPCNT check_unique_words_popcnt(worker_t *RESTRICT w)
+{
+	check_unique_words_common(w, true, 1);
+}
+
+static void HOT TARGET_POPCNT check_unique_words_popcnt_lanes(worker_t *RESTRICT w)
+{
+	check_unique_words_common(w, true, DICT_LANES);
+}
+#endif
+
+/*
+ *  Initialise the parser
+ */
+static inline HOT void parser_new(
+	parser_t *RESTRICT p,
+	unsigned char *RESTRICT data,
+	unsigned char *RESTRICT data_end,
+	const bool skip_white_space)
+{
+	p->data = data;
+	p->data_end = data_end;
+	p->ptr = data;
+	p->skip_white_space = skip_white_space;
+	__builtin_memset(&p->scope, 0, sizeof(p->scope));
+	p->scope.data = data;
+}
+
+/*
+ *  Get next character from input stream
+ */
+static inline get_char_t HOT get_char(register parser_t *p)
+{
+	if (LIKELY(p->ptr < p->data_end)) {
+		return *(p->ptr++);
+	} else
+		return PARSER_EOF;
+}
+
+/*
+ *  Push character back onto the input
+ *  stream (in this case, it is a simple FIFO stack
+ */
+static inline void HOT unget_char(parser_t *p)
+{
+	//if (LIKELY(p->ptr > p->data))
+	p->ptr--;
+}
+
+/*
+ *  Clear the token ready for re-use, this drops any
+ *  view and goes back to the token buffer. The last
+ *  byte of the buffer is kept for the terminating '\0'
+ */
+static inline void HOT token_clear(token_t *t)
+{
+	t->token = t->buf;
+	t->ptr = t->buf;
+	t->token_end = t->buf + t->len - 1;
+	t->type = TOKEN_UNKNOWN;
+	*(t->ptr) = '\0';
+}
+
+/*
+ *  Make the token a view of len bytes of the input rather
+ *  than copying them into the token buffer. The input is
+ *  read-only, token_end is set to the start of the view so
+ *  that any append takes the token_expand() slow path and
+ *  copies the view into the token buffer first.
+ */
+static inline void HOT token_view(
+	register token_t *RESTRICT t,
+	register void *RESTRICT start,
+	register const size_t len)
+{
+	t->token = start;
+	t->ptr = t->token + len;
+	t->token_end = t->token;
+}
+
+static inline bool HOT token_is_view(register const token_t *t)
+{
+	return t->token_end != t->buf + t->len - 1;
+}
+
+/*
+ *  Create a new token, give it plenty of slop so
+ *  we don't need to keep on reallocating the token
+ *  buffer as we append more characters to it during
+ *  the lexing phase.
+ */
+static void token_new(token_t *t)
+{
+	int ret;
+
+	ret = posix_memalign((void **)&t->buf, 64, TOKEN_CHUNK_SIZE);
+	if (ret != 0)
+		out_of_memory();
+	t->len = TOKEN_CHUNK_SIZE;
+	token_clear(t);
+}
+
+/*
+ *  Free the token
+ */
+static void token_free(token_t *t)
+{
+	free(t->buf);
+	t->ptr = NULL;
+	t->token = NULL;
+	t->token_end = NULL;
+	t->buf = NULL;
+	t->len = 0;
+}
+
+/*
+ *  Make space for at least n more characters, a view
+ *  is copied into the token buffer so it can be modified
+ */
+static void HOT token_expand(token_t *t, const size_t n)
+{
+	const bool view = token_is_view(t);
+	const size_t used = t->ptr - t->token;
+	const size_t offset = view ? 0 : (size_t)(t->token - t->buf);
+	const size_t needed = offset + used + n + 1;
+
+	if (needed > t->len) {
+		char *buf;
+
+		/* No more space, double it so appends stay amortised O(1) */
+		while (needed > t->len)
+			t->len <<= 1;
+		buf = realloc(t->buf, t->len);
+		if (UNLIKELY(!buf))
+			out_of_memory();
+		t->buf = buf;
+	}
+	if (view)
+		__builtin_memcpy(t->buf, t->token, used);
+	t->token = t->buf + offset;
+	t->ptr = t->token + used;
+	t->token_end = t->buf + t->len - 1;
+}
+
+/*
+ *  Append a single character to the token
+ */
+static inline void HOT token_append(register token_t *t, register const get_char_t ch)
+{
+	if (LIKELY(t->ptr < (t->token_end))) {
+		*(t->ptr++) = ch;
+	} else {
+		token_expand(t, 1);
+		*(t->ptr++) = ch;
+	}
+}
+
+/*
+ *  Append len characters to the token
+ */
+static inline void HOT token_append_str(
+	register token_t *RESTRICT t,
+	register const char *RESTRICT str,
+	register const size_t len)
+{
+	if (UNLIKELY((size_t)(t->token_end - t->ptr) < len))
+		token_expand(t, len);
+	__builtin_memcpy(t->ptr, str, len);
+	t->ptr += len;
+}
+
+/*
+ *  Terminate the token, never used on a view
+ */
+static inline void HOT token_eos(token_t *t)
+{
+	*(t->ptr) = '\0';
+}
+
+static inline void HOT token_cat_str(register token_t *RESTRICT t, register const char *RESTRICT str)
+{
+	token_append_str(t, str, __builtin_strlen(str));
+	token_eos(t);
+}
+
+#if defined(HAVE_SCAN_X86)
+/*
+ *  Byte mask of the bytes in the range lo..hi
+ */
+static inline __m128i TARGET_SSE2 scan_range_sse2(const __m128i v, const char lo, const char hi)
+{
+	const __m128i x = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+
+	return _mm_cmpeq_epi8(_mm_min_epu8(x, _mm_set1_epi8(hi - lo)), x);
+}
+
+static inline uint64_t TARGET_SSE2 scan_eq_sse2(const __m128i v, const char ch)
+{
+	return (uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(ch)));
+}
+
+/*
+ *  Index a block 16 bytes at a time
+ */
+static void HOT TARGET_SSE2 scan_classify_sse2(
+	const unsigned char *RESTRICT ptr,
+	scan_block_t *RESTRICT b)
+{
+	register size_t i;
+
+	__builtin_memset(b, 0, sizeof(*b));
+	for (i = 0; i < SCAN_BLOCK_SIZE; i += 16) {
+		const __m128i v = _mm_loadu_si128((const __m128i *)(const void *)(ptr + i));
+		const __m128i ident =
+			_mm_or_si128(_mm_or_si128(
+				scan_range_sse2(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 'z'),
+				scan_range_sse2(v, '0', '9')),
+				_mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+
+		b->identifier |= (uint64_t)(uint16_t)_mm_movemask_epi8(ident) << i;
+		b->quote |= scan_eq_sse2(v, '"') << i;
+		b->apostrophe |= scan_eq_sse2(v, '\'') << i;
+		b->slash |= scan_eq_sse2(v, '/') << i;
+		b->star |= scan_eq_sse2(v, '*') << i;
+		b->hash |= scan_eq_sse2(v, '#') << i;
+		b->newline |= scan_eq_sse2(v, '\n') << i;
+		b->backslash |= scan_eq_sse2(v, '\\') << i;
+		b->brace_opened |= scan_eq_sse2(v, '{') << i;
+		b->brace_closed |= scan_eq_sse2(v, '}') << i;
+		b->semicolon |= scan_eq_sse2(v, ';') << i;
+	}
+}
+
+static inline __m256i TARGET_AVX2 scan_range_avx2(const __m256i v, const char lo, const char hi)
+{
+	const __m256i x = _mm256_sub_epi8(v, _mm256_set1_epi8(lo));
+
+	return _mm256_cmpeq_epi8(_mm256_min_epu8(x, _mm256_set1_epi8(hi - lo)), x);
+}
+
+static inline uint64_t TARGET_AVX2 scan_eq_avx2(const __m256i v, const char ch)
+{
+	return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(ch)));
+}
+
+/*
+ *  Index a block 32 bytes at a time
+ */
+static void HOT TARGET_AVX2 scan_classify_avx2(
+	const unsigned char *RESTRICT ptr,
+	scan_block_t *RESTRICT b)
+{
+	register size_t i;
+
+	__builtin_memset(b, 0, sizeof(*b));
+	for (i = 0; i < SCAN_BLOCK_SIZE; i += 32) {
+		const __m256i v = _mm256_loadu_si256((const __m256i *)(const void *)(ptr + i));
+		const __m256i ident =
+			_mm256_or_si256(_mm256_or_si256(
+				scan_range_avx2(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), 'a', 'z'),
+				scan_range_avx2(v, '0', '9')),
+				_mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')));
+
+		b->identifier |= (uint64_t)(uint32_t)_mm256_movemask_epi8(ident) << i;
+		b->quote |= scan_eq_avx2(v, '"') << i;
+		b->apostrophe |= scan_eq_avx2(v, '\'') << i;
+		b->slash |= scan_eq_avx2(v, '/') << i;
+		b->star |= scan_eq_avx2(v, '*') << i;
+		b->hash |= scan_eq_avx2(v, '#') << i;
+		b->newline |= scan_eq_avx2(v, '\n') << i;
+		b->backslash |= scan_eq_avx2(v, '\\') << i;
+		b->brace_opened |= scan_eq_avx2(v, '{') << i;
+		b->brace_closed |= scan_eq_avx2(v, '}') << i;
+		b->semicolon |= scan_eq_avx2(v, ';') << i;
+	}
+}
+#endif
+
+/*
+ *  Index a block a byte at a time
+ */
+static void HOT scan_classify_generic(
+	const unsigned char *RESTRICT ptr,
+	scan_block_t *RESTRICT b)
+{
+	register size_t i;
+
+	__builtin_memset(b, 0, sizeof(*b));
+	for (i = 0; i < SCAN_BLOCK_SIZE; i++) {
+		register const uint16_t c = scan_class[ptr[i]];
+		register const uint64_t bit = 1ULL << i;
+
+		if (!c)
+			continue;
+		if (c & SCAN_IDENTIFIER)
+			b->identifier |= bit;
+		if (c & SCAN_QUOTE)
+			b->quote |= bit;
+		if (c & SCAN_APOSTROPHE)
+			b->apostrophe |= bit;
+		if (c & SCAN_SLASH)
+			b->slash |= bit;
+		if (c & SCAN_STAR)
+			b->star |= bit;
+		if (c & SCAN_HASH)
+			b->hash |= bit;
+		if (c & SCAN_NEWLINE)
+			b->newline |= bit;
+		if (c & SCAN_BACKSLASH)
+			b->backslash |= bit;
+		if (c & SCAN_BRACE_OPENED)
+			b->brace_opened |= bit;
+		if (c & SCAN_BRACE_CLOSED)
+			b->brace_closed |= bit;
+		if (c & SCAN_SEMICOLON)
+			b->semicolon |= bit;
+	}
+}
+
+/*
+ *  Stage 1 of the scan, build the structural index of the
+ *  SCAN_BLOCK_SIZE bytes at ptr.  A short block at the end
+ *  of the data is padded with zeros which are in no class.
+ */
+static inline void HOT scan_index(
+	register const unsigned char *ptr,
+	register const unsigned char *const data_end,
+	scan_block_t *RESTRICT b)
+{
+	unsigned char buf[SCAN_BLOCK_SIZE] ALIGNED(64);
+
+	if (UNLIKELY(data_end - ptr < SCAN_BLOCK_SIZE)) {
+		__builtin_memset(buf, 0, sizeof(buf));
+		__builtin_memcpy(buf, ptr, data_end - ptr);
+		ptr = buf;
+	}
+	scan_classify(ptr, b);
+}
+
+/*
+ *  Count the newlines from ptr to end a byte at a time
+ */
+static uint32_t HOT count_newlines_generic(
+	register const unsigned char *RESTRICT ptr,
+	register const unsigned char *RESTRICT end)
+{
+	register uint32_t n = 0;
+
+	for (; ptr < end; ptr++)
+		n += (*ptr == '\n');
+	return n;
+}
+
+/*
+ *  Store the offset from ptr of each newline up to end
+ */
+static void HOT index_newlines_generic(
+	const unsigned char *RESTRICT ptr,
+	const unsigned char *RESTRICT end,
+	uint32_t *RESTRICT offsets)
+{
+	register const unsigned char *p;
+
+	for (p = ptr; p < end; p++)
+		if (*p == '\n')
+			*offsets++ = p - ptr;
+}
+
+#if defined(HAVE_SCAN_X86)
+/*
+ *  Count the newlines 32 bytes at a time, the compares count
+ *  down per byte lane and the lanes are summed before any of
+ *  them can wrap
+ */
+static uint32_t HOT TARGET_AVX2 count_newlines_avx2(
+	const unsigned char *RESTRICT ptr,
+	const unsigned char *RESTRICT end)
+{
+	const __m256i nl = _mm256_set1_epi8('\n');
+	__m256i sum = _mm256_setzero_si256();
+	uint64_t lanes[4];
+
+	while (end - ptr >= 32) {
+		__m256i acc = _mm256_setzero_si256();
+		register int i;
+
+		for (i = 0; (i < 255) && (end - ptr >= 32); i++, ptr += 32) {
+			const __m256i v = _mm256_loadu_si256((const __m256i *)(const void *)ptr);
+
+			acc = _mm256_sub_epi8(acc, _mm256_cmpeq_epi8(v, nl));
+		}
+		sum = _mm256_add_epi64(sum, _mm256_sad_epu8(acc, _mm256_setzero_si256()));
+	}
+	_mm256_storeu_si256((__m256i *)(void *)lanes, sum);
+
+	return (uint32_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]) +
+		count_newlines_generic(ptr, end);
+}
+
+static void HOT TARGET_AVX2 index_newlines_avx2(
+	const unsigned char *RESTRICT ptr,
+	const unsigned char *RESTRICT end,
+	uint32_t *RESTRICT offsets)
+{
+	const __m256i nl = _mm256_set1_epi8('\n');
+	register uint32_t base;
+
+	for (base = 0; end - (ptr + base) >= 64; base += 64) {
+		const __m256i v0 = _mm256_loadu_si256((const __m256i *)(const void *)(ptr + base));
+		const __m256i v1 = _mm256_loadu_si256((const __m256i *)(const void *)(ptr + base + 32));
+		register uint64_t mask =
+			(uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v0, nl)) |
+			(uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v1, nl)) << 32;
+
+		while (mask) {
+			*offsets++ = base + __builtin_ctzll(mask);
+			mask &= mask - 1;
+		}
+	}
+	for (; ptr + base < end; base++)
+		if (ptr[base] == '\n')
+			*offsets++ = base;
+}
+
+static uint32_t HOT TARGET_SSE2 count_newlines_sse2(
+	const unsigned char *RESTRICT ptr,
+	const unsigned char *RESTRICT end)
+{
+	const __m128i nl = _mm_set1_epi8('\n');
+	__m128i sum = _mm_setzero_si128();
+	uint64_t lanes[2];
+
+	while (end - ptr >= 16) {
+		__m128i acc = _mm_setzero_si128();
+		register int i;
+
+		for (i = 0; (i < 255) && (end - ptr >= 16); i++, ptr += 16) {
+			const __m128i v = _mm_loadu_si128((const __m128i *)(const void *)ptr);
+
+			acc = _mm_sub_epi8(acc, _mm_cmpeq_epi8(v, nl));
+		}
+		sum = _mm_add_epi64(sum, _mm_sad_epu8(acc, _mm_setzero_si128()));
+	}
+	_mm_storeu_si128((__m128i *)(void *)lanes, sum);
+
+	return (uint32_t)(lanes[0] + lanes[1]) + count_newlines_generic(ptr, end);
+}
+
+static void HOT TARGET_SSE2 index_newlines_sse2(
+	const unsigned char *RESTRICT ptr,
+	const unsigned char *RESTRICT end,
+	uint32_t *RESTRICT offsets)
+{
+	const __m128i nl = _mm_set1_epi8('\n');
+	register uint32_t base;
+
+	for (base = 0; end - (ptr + base) >= 16; base += 16) {
+		const __m128i v = _mm_loadu_si128((const __m128i *)(const void *)(ptr + base));
+		register uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl));
+
+		while (mask) {
+			*offsets++ = base + __builtin_ctz(mask);
+			mask &= mask - 1;
+		}
+	}
+	for (; ptr + base < end; base++)
+		if (ptr[base] == '\n')
+			*offsets++ = base;
+}
+#endif
+
+/*
+ *  Start the newline index for a new file, returns the
+ *  number of newlines in it
+ */
+static inline uint32_t newline_index_reset(
+	newline_index_t *RESTRICT idx,
+	const unsigned char *data,
+	const unsigned char *data_end)
+{
+	idx->data = data;
+	idx->data_end = data_end;
+	idx->newlines = count_newlines(data, data_end);
+	idx->built = false;
+
+	return idx->newlines;
+}
+
+/*
+ *  Line and column of ptr, both counted from 1, found by a
+ *  binary search of the newline offsets
+ */
+static void newline_index_find(
+	newline_index_t *RESTRICT idx,
+	const unsigned char *ptr,
+	uint32_t *RESTRICT lineno,
+	uint32_t *RESTRICT column)
+{
+	const uint32_t pos = ptr - idx->data;
+	register uint32_t lo = 0, hi = idx->newlines;
+
+	if (UNLIKELY(!idx->built)) {
+		if (idx->newlines > idx->size) {
+			uint32_t *offsets;
+
+			idx->size = idx->newlines + (idx->newlines >> 1);
+			offsets = realloc(idx->offsets, idx->size * sizeof(*offsets));
+			if (UNLIKELY(!offsets))
+				out_of_memory();
+			idx->offsets = offsets;
+		}
+		index_newlines(idx->data, idx->data_end, idx->offsets);
+		idx->built = true;
+	}
+
+	/* lo ends up as the number of newlines before pos */
+	while (lo < hi) {
+		register const uint32_t mid = (lo + hi) >> 1;
+
+		if (idx->offsets[mid] < pos)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	*lineno = lo + 1;
+	*column = pos - (lo ? idx->offsets[lo - 1] + 1 : 0) + 1;
+}
+
+/*
+ *  Find the end of a literal, ptr is just after the opening
+ *  quote and a backslash escapes the next character.  Returns
+ *  the closing quote or NULL if the literal is not terminated.
+ *  Literals are short, so rather than index whole blocks this
+ *  just looks for the next quote or backslash 16 bytes at a time.
+ */
+static inline unsigned char HOT *scan_literal_end(
+	register unsigned char *ptr,
+	register const unsigned char *const data_end,
+	const get_char_t literal)
+{
+#if defined(__SSE2__)
+	const __m128i quote = _mm_set1_epi8((char)literal);
+	const __m128i backslash = _mm_set1_epi8('\\');
+
+	while (LIKELY(data_end - ptr >= 16)) {
+		const __m128i v = _mm_loadu_si128((const __m128i *)(const void *)ptr);
+		const uint32_t mask = _mm_movemask_epi8(
+			_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)));
+
+		if (!mask) {
+			ptr += 16;
+			continue;
+		}
+		ptr += __builtin_ctz(mask);
+		if (LIKELY(*ptr != '\\'))
+			return ptr;
+		ptr += 2;
+	}
+#endif
+	for (; ptr < data_end; ptr++) {
+		if (*ptr == '\\')
+			ptr++;
+		else if (*ptr == literal)
+			return ptr;
+	}
+	return NULL;
+}
+
+/*
+ *  Skip over a literal, matching parse_literal()
+ */
+static inline unsigned char HOT *scan_literal(
+	register unsigned char *ptr,
+	register unsigned char *const data_end)
+{
+	ptr = scan_literal_end(ptr + 1, data_end, *ptr);
+
+	return ptr ? ptr + 1 : data_end;
+}
+
+/*
+ *  Find the end of a C comment, ptr is just after the opening
+ *  slash star.  Returns the character after the closing star
+ *  slash or NULL if the comment is not terminated.
+ */
+static inline unsigned char HOT *scan_comment_end(
+	register unsigned char *ptr,
+	register const unsigned char *const data_end)
+{
+	/*
+	 *  Look for a * followed by a /, the blocks overlap
+	 *  by a byte to catch a pair split across two blocks
+	 */
+	for (; ptr < data_end; ptr += SCAN_BLOCK_SIZE - 1) {
+		scan_block_t b;
+		uint64_t end;
+
+		scan_index(ptr, data_end, &b);
+		end = b.star & (b.slash >> 1);
+		if (end)
+			return ptr + __builtin_ctzll(end) + 2;
+		if (data_end - ptr <= SCAN_BLOCK_SIZE)
+			break;
+	}
+	return NULL;
+}
+
+/*
+ *  Find the end of a pre-processor line, ptr is just after the
+ *  hash. A backslash anywhere on a line continues the macro on
+ *  the next line, so a newline ends the macro if there is no
+ *  backslash since the previous newline.  Returns the character
+ *  after that newline or NULL if there is none.
+ */
+static inline unsigned char HOT *scan_macro_end(
+	register unsigned char *ptr,
+	register const unsigned char *const data_end)
+{
+	uint64_t continuation = 0;
+
+	for (; ptr < data_end; ptr += SCAN_BLOCK_SIZE) {
+		scan_block_t b;
+		uint64_t gap, continued, end;
+		bool carry;
+
+		scan_index(ptr, data_end, &b);
+
+		/*
+		 *  Carry each backslash forward over the gap to the
+		 *  next backslash or newline, the newlines it lands
+		 *  on are continued
+		 */
+		gap = ~(b.newline | b.backslash);
+		carry = __builtin_add_overflow(gap, b.backslash << 1, &continued);
+		carry |= __builtin_add_overflow(continued, continuation, &continued);
+		continuation = carry | (b.backslash >> 63);
+
+		end = b.newline & ~continued;
+		if (end)
+			return ptr + __builtin_ctzll(end) + 1;
+		if (data_end - ptr <= SCAN_BLOCK_SIZE)
+			break;
+	}
+	return NULL;
+}
+
+static get_char_t HOT skip_macros(register parser_t *p)
+{
+	register unsigned char *ptr;
+
+	ptr = scan_macro_end(p->ptr, p->data_end);
+	if (UNLIKELY(!ptr)) {
+		p->ptr = p->data_end;
+		return PARSER_EOF;
+	}
+	p->ptr = ptr;
+
+	return '\n';
+}
+
+/*
+ *  Parse C comments and just throw them away
+ */
+static get_char_t HOT TARGET_CLONES skip_comments(parser_t *p)
+{
+	register unsigned char *ptr;
+	register get_char_t nextch;
+
+	nextch = get_char(p);
+
+	if (nextch == '/') {
+		ptr = memchr(p->ptr, '\n', p->data_end - p->ptr);
+		if (UNLIKELY(!ptr)) {
+			p->ptr = p->data_end;
+			return PARSER_EOF;
+		}
+		p->ptr = ptr + 1;
+		return PARSER_COMMENT_FOUND;
+	}
+
+	if (LIKELY(nextch == '*')) {
+		ptr = scan_comment_end(p->ptr, p->data_end);
+		if (UNLIKELY(!ptr)) {
+			p->ptr = p->data_end;
+			return PARSER_EOF;
+		}
+		p->ptr = ptr;
+		return PARSER_COMMENT_FOUND;
+	}
+	if (UNLIKELY(nextch == PARSER_EOF))
+		return nextch;
+
+	/* Not a comment, push back */
+	unget_char(p);
+
+	return PARSER_OK;
+}
+
+/*
+ *  Parse an integer.  This is fairly minimal as the
+ *  kernel doesn't have floats or doubles, so we
+ *  can just parse decimal, octal or hex values.
+ */
+static get_char_t HOT TARGET_CLONES parse_number(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+{
+	unsigned char *start = p->ptr - 1;
+	bool ishex = false;
+	bool isoct = false;
+
+	/*
+	 *  Crude way to detect the kind of integer
+	 */
+	if (LIKELY(ch == '0')) {
+		register get_char_t nextch1, nextch2;
+
+		nextch1 = get_char(p);
+
+		if (nextch1 >= '0' && nextch1 <= '8') {
+			/* Must be an octal value */
+			isoct = true;
+		} else if (nextch1 == 'x' || nextch1 == 'X') {
+			/* Is it hexadecimal? */
+			nextch2 = get_char(p);
+
+			if (isxdigit(nextch2)) {
+				/* Hexadecimal */
+				ishex = true;
+			} else if (LIKELY(nextch2 != PARSER_EOF)) {
+				/* Nope */
+				unget_char(p);
+				unget_char(p);
+				token_view(t, start, 1);
+				return PARSER_OK;
+			} else {
+				unget_char(p);
+				token_view(t, start, 1);
+				return PARSER_OK;
+			}
+		} else if (LIKELY(nextch1 != PARSER_EOF)) {
+			unget_char(p);
+			token_view(t, start, 1);
+			return PARSER_OK;
+		} else {
+			token_view(t, start, 1);
+			return PARSER_OK;
+		}
+	}
+
+	/*
+	 * OK, we now know what type of integer we
+	 * are processing, so just gather up the digits
+	 */
+	for (;;) {
+		ch = get_char(p);
+
+		if (UNLIKELY(ch == PARSER_EOF))
+			break;
+
+		if (ishex) {
+			if (UNLIKELY(!isxdigit(ch)))
+				goto unget;
+		} else if (isoct) {
+			if (UNLIKELY(!(ch >= '0' && ch <= '8')))
+				goto unget;
+		} else {
+			if (!isdigit(ch))
+				goto unget;
+		}
+	}
+	token_view(t, start, p->ptr - start);
+	return PARSER_OK;
+
+unget:
+	unget_char(p);
+	token_view(t, start, p->ptr - start);
+	return PARSER_OK;
+}
+
+/*
+ *  Parse identifiers
+ */
+static get_char_t HOT parse_identifier(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+{
+	register unsigned char *ptr = p->ptr;
+	register const unsigned char *const data_end = p->data_end;
+
+	(void)ch;
+
+	while (LIKELY(ptr < data_end) && !is_not_identifier[*ptr])
+		ptr++;
+
+	t->type = TOKEN_IDENTIFIER;
+	token_view(t, p->ptr - 1, ptr - p->ptr + 1);
+	p->ptr = ptr;
+
+	return PARSER_OK;
+}
+
+/*
+ *  Strip the escapes from the literal start..end, this copies
+ *  the runs between the backslashes into the token.  \? becomes
+ *  ?, control character escapes become a space and the others
+ *  are kept. A control character escape at the end of a literal
+ *  only becomes a space if the literal is followed by another
+ *  literal, need to transform:
+ * 	"foo\n" -> "foo"
+ * 	"foo\nbar" -> "foo bar"
+ *	"foo\n"<newlines>"bar" -> "foo "<newlines>"bar"
+ */
+static void literal_unescape(
+	parser_t *RESTRICT p,
+	token_t *RESTRICT t,
+	register unsigned char *ptr,
+	unsigned char *const end,
+	const bool terminated)
+{
+	register unsigned char *const content_end = terminated ? end - 1 : end;
+	register unsigned char *bs;
+	const unsigned char literal = *ptr;
+
+	while ((bs = memchr(ptr, '\\', content_end - ptr)) != NULL) {
+		token_append_str(t, (char *)ptr, bs - ptr);
+		ptr = bs + 2;
+
+		/* A backslash at the end of the data escapes nothing */
+		if (UNLIKELY(ptr > content_end)) {
+			ptr = content_end;
+			break;
+		}
+
+		switch (bs[1]) {
+		case '?':
+			token_append(t, '?');
+			break;
+		case 'a':
+		case 'b':
+		case 'f':
+		case 'n':
+		case 'r':
+		case 't':
+		case 'v':
+			if ((ptr == content_end) && terminated) {
+				register const unsigned char *next = end;
+
+				while ((next < p->data_end) && (*next == '\n'))
+					next++;
+				if ((next >= p->data_end) || (*next != literal))
+					break;
+			}
+			token_append(t, ' ');
+			break;
+		default:
+			token_append(t, '\\');
+			token_append(t, bs[1]);
+			break;
+		}
+	}
+	token_append_str(t, (char *)ptr, end - ptr);
+	token_eos(t);
+}
+
+/*
+ *  Parse literal strings, the token is a view of the literal
+ *  in the input unless escapes need stripping
+ */
+static get_char_t TARGET_CLONES parse_literal(
+	parser_t *RESTRICT p,
+	token_t *RESTRICT t,
+	const get_char_t literal,
+	const token_type_t type)
+{
+	unsigned char *start = p->ptr - 1;
+	unsigned char *end = scan_literal_end(p->ptr, p->data_end, literal);
+	get_char_t ret = PARSER_OK;
+	bool terminated = true;
+
+	if (LIKELY(end != NULL)) {
+		end++;
+	} else {
+		register unsigned char *bs;
+
+		/* An odd run of backslashes at the end escapes the end of data */
+		end = p->data_end;
+		for (bs = end; (bs > p->ptr) && (bs[-1] == '\\'); bs--)
+			;
+		if ((end - bs) & 1)
+			ret = PARSER_EOF;
+		terminated = false;
+	}
+	p->ptr = end;
+
+	if (UNLIKELY(opt_flags & OPT_ESCAPE_STRIP) &&
+	    memchr(start + 1, '\\', end - (start + 1))) {
+		token_clear(t);
+		literal_unescape(p, t, start, end, terminated);
+	} else {
+		token_view(t, start, end - start);
+	}
+	t->type = type;
+
+	return ret;
+}
+
+/*
+ *  Parse operators such as +, - which can
+ *  be + or ++ forms.
+ */
+static inline get_char_t parse_op(parser_t *RESTRICT p, token_t *RESTRICT t, const get_char_t op)
+{
+	token_append(t, op);
+
+	if (get_char(p) == op) {
+		token_append(t, op);
+		token_eos(t);
+		return PARSER_OK;
+	}
+
+	unget_char(p);
+	token_eos(t);
+	return PARSER_OK;
+}
+
+/*
+ *  Parse -, --, ->
+ */
+static inline get_char_t parse_minus(parser_t *RESTRICT p, token_t *RESTRICT t, const get_char_t op)
+{
+	register get_char_t ch;
+
+	token_append(t, op);
+
+	ch = get_char(p);
+
+	if (ch == op) {
+		token_append(t, ch);
+		token_eos(t);
+		return PARSER_OK;
+	}
+
+	if (LIKELY(ch == '>')) {
+		token_append(t, ch);
+		token_eos(t);
+		t->type = TOKEN_ARROW;
+		return PARSER_OK;
+	}
+
+	unget_char(p);
+	token_eos(t);
+	return PARSER_OK;
+}
+
+static inline get_char_t parse_skip_comments(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+{
+	get_char_t ret = skip_comments(p);
+
+	if (ret == PARSER_COMMENT_FOUND) {
+		ret |= PARSER_CONTINUE;
+		return ret;
+	}
+	if (UNLIKELY(ret == PARSER_EOF))
+		return ret;
+
+	token_append(t, ch);
+	token_eos(t);
+	return PARSER_OK;
+}
+
+static inline get_char_t parse_simple(token_t *t, get_char_t ch, const token_type_t type)
+{
+	token_append(t, ch);
+	token_eos(t);
+	t->type = type;
+	return PARSER_OK;
+}
+
+static inline get_char_t parse_hash(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+{
+	(void)p;
+	(void)ch;
+
+	skip_macros(p);
+	token_clear(t);
+
+	return PARSER_OK;
+}
+
+static inline get_char_t parse_paren_opened(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+{
+	(void)p;
+
+	return parse_simple(t, ch, TOKEN_PAREN_OPENED);
+}
+
+static inline get_char_t parse_paren_closed(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+{
+	(void)p;
+
+	return parse_simple(t, ch, TOKEN_PAREN_CLOSED);
+}
+
+
+static inline get_char_t parse_square_opened(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+{
+	(void)p;
+
+	return parse_simple(t, ch, TOKEN_SQUARE_OPENED);
+}
+
+static inline get_char_t parse_square_closed(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+{
+	(void)p;
+
+	return parse_simple(t, ch, TOKEN_SQUARE_CLOSED);
+}
+
+static inline get_char_t parse_less_than(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+{
+	(void)p;
+
+	return parse_simple(t, ch, TOKEN_LESS_THAN);
+}
+
+static inline get_char_t parse_greater_than(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+{
+	(void)p;
+
+	return parse_simple(t, ch, TOKEN_GREATER_THAN);
+}
+
+static inline get_char_t parse_comma(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+{
+	(void)p;
+
+	return parse_simple(t, ch, TOKEN_COMMA);
+}
+
+/*
+ *  A ; at file scope ends a declaration, so a prototype's
+ *  name does not name whatever braces follow it
+ */
+static inline void scope_terminal(scope_t *s)
+{
+	if (!s->depth)
+		s->name = NULL;
+}
+
+static inline get_char_t parse_terminal(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+{
+	scope_terminal(&p->scope);
+	return parse_simple(t, ch, TOKEN_TERMINAL);
+}
+
+static inline get_char_t parse_misc_char(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+{
+	(void)p;
+
+	token_append(t, ch);
+	token_eos(t);
+	return PARSER_OK;
+}
+
+/*
+ *  A { at file scope starts the body of the function named by
+ *  the last function like name, nothing else at file scope
+ *  has messages in its braces
+ */
+static inline void scope_enter(scope_t *s)
+{
+	if (!s->depth++) {
+		s->function = s->name;
+		s->function_len = s->name_len;
+	}
+}
+
+static inline void scope_leave(scope_t *s)
+{
+	if (s->depth && !--s->depth) {
+		s->function = NULL;
+		s->name = NULL;
+	}
+}
+
+/*
+ *  Note an identifier from start to end at file scope if it
+ *  names a function, that is it is followed by a ( and does
+ *  not follow a ) as __acquires() and friends do
+ */
+static inline void scope_name(
+	scope_t *RESTRICT s,
+	const unsigned char *start,
+	const unsigned char *end,
+	const unsigned char *const data_end)
+{
+	register const unsigned char *ptr;
+
+	if (isdigit(*start))
+		return;
+	for (ptr = end; (ptr < data_end) && isspace(*ptr); ptr++)
+		;
+	if ((ptr >= data_end) || (*ptr != '('))
+		return;
+	for (ptr = start; (ptr > s->data) && isspace(ptr[-1]); ptr--)
+		;
+	if ((ptr > s->data) && (ptr[-1] == ')'))
+		return;
+	s->name = start;
+	s->name_len = end - start;
+}
+
+static inline get_char_t parse_brace_opened(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+{
+	scope_enter(&p->scope);
+	return parse_misc_char(p, t, ch);
+}
+
+static inline get_char_t parse_brace_closed(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+{
+	scope_leave(&p->scope);
+	return parse_misc_char(p, t, ch);
+}
+
+static inline get_char_t parse_literal_string(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+{
+	return parse_literal(p, t, ch, TOKEN_LITERAL_STRING);
+}
+
+static inline get_char_t parse_literal_char(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+{
+	return parse_literal(p, t, ch, TOKEN_LITERAL_CHAR);
+}
+
+static inline get_char_t parse_backslash(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+{
+	if (p->skip_white_space)
+		return PARSER_OK | PARSER_CONTINUE;
+
+	if (opt_flags & OPT_ESCAPE_STRIP) {
+		token_append(t, ch);
+		token_eos(t);
+		t->type = TOKEN_WHITE_SPACE;
+	} else {
+		token_append(t, ch);
+		ch = get_char(p);
+		if (UNLIKELY(ch == PARSER_EOF))
+			return ch;
+		token_append(t, ch);
+		token_eos(t);
+	}
+	return PARSER_OK;
+}
+
+static inline get_char_t parse_eof(parser_t *RESTRICT p, token_t *RESTRICT t, register get_char_t ch)
+{
+	(void)p;
+	(void)t;
+	(void)ch;
+
+	return PARSER_EOF;
+}
+
+/*
+ *  White space is squashed down to the first white space
+ *  character followed by a space, so the token is a view
+ *  of a constant string
+ */
+static inline get_char_t TARGET_CLONES parse_whitespace(
+	parser_t *RESTRICT p,
+	token_t *RESTRICT t,
+	const get_char_t ch)
+{
+	static char space_space[] = "  ";
+	static char tab_space[] = "\t ";
+	register unsigned char *ptr = p->ptr;
+	register const unsigned char *const data_end = p->data_end;
+
+	while (LIKELY(ptr < data_end) && !is_not_whitespace[*ptr])
+		ptr++;
+	p->ptr = ptr;
+
+	t->type = TOKEN_WHITE_SPACE;
+	token_view(t, (ch == ' ') ? space_space : tab_space, 2);
+
+	return PARSER_OK;
 }
 
 static get_token_action_t get_token_actions[] = {
@@ -3491,8 +3198,8 @@ static get_token_action_t get_token_actions[] = {
 	['>'] = parse_greater_than,
 	[','] = parse_comma,
 	[';'] = parse_terminal,
-	['{'] = parse_misc_char,
-	['}'] = parse_misc_char,
+	['{'] = parse_brace_opened,
+	['}'] = parse_brace_closed,
 	[':'] = parse_misc_char,
 	['~'] = parse_misc_char,
 	['?'] = parse_misc_char,
@@ -3571,7 +3278,7 @@ static get_token_action_t get_token_actions[] = {
 	['"'] = parse_literal_string,
 	['\''] = parse_literal_char,
 	['\\'] = parse_backslash,
-	['\n'] = parse_newline,
+	['\n'] = parse_backslash,
 	[' '] = parse_whitespace,
 	['\t'] = parse_whitespace,
 	[PARSER_EOF] = parse_eof,
@@ -3579,341 +3286,2303 @@ static get_token_action_t get_token_actions[] = {
 
 
 /*
- *  Gather a token from input stream
+ *  Gather a token from input stream
+ */
+static get_char_t HOT get_token(register parser_t *RESTRICT p, register token_t *RESTRICT t)
+{
+	for (;;) {
+		register get_char_t ret, ch = get_char(p);
+		register get_token_action_t action = get_token_actions[ch];
+
+		if (UNLIKELY(!action))
+			continue;
+
+		ret = action(p, t, ch);
+		if (UNLIKELY(ret & PARSER_CONTINUE))
+			continue;
+		return ret;
+	}
+
+	return PARSER_OK;
+}
+
+/*
+ *  Literals such as "foo" and 'f' sometimes
+ *  need the quotes stripping off, just narrow
+ *  the token rather than moving the text
+ */
+static inline void literal_strip_quotes(token_t *t)
+{
+	t->token++;
+	if (LIKELY(t->ptr > t->token))
+		t->ptr--;
+}
+
+/*
+ *  Concatenate new string onto old. The old
+ *  string can be NULL or an existing string
+ *  on the heap.  This returns the newly
+ *  concatenated string.
+ */
+static void token_cat_normal(
+	token_t *RESTRICT token,
+	token_t *RESTRICT token_to_add)
+{
+	token_append_str(token, token_to_add->token, token_len(token_to_add));
+	token_eos(token);
+}
+
+/*
+ *  Concatenate new string onto old. The old
+ *  string can be NULL or an existing string
+ *  on the heap.  This returns the newly
+ *  concatenated string.
+ */
+static void token_cat_just_literal_string(
+	token_t *RESTRICT token,
+	token_t *RESTRICT token_to_add)
+{
+	if (token_to_add->type == TOKEN_LITERAL_STRING) {
+		token_append_str(token, token_to_add->token, token_len(token_to_add));
+		token_eos(token);
+	}
+}
+
+/*
+ *  Replace each format specifier with a space, the format
+ *  DFA consumes the longest specifier after each '%' in a
+ *  single pass
+ */
+static void TARGET_CLONES strip_format(char *line)
+{
+	register char *ptr1 = line, *ptr2 = line;
+
+	while (*ptr1) {
+		if (UNLIKELY((*ptr1 == '%') && *(ptr1 + 1))) {
+			register char *ptr = ++ptr1;
+			register uint32_t state = FORMAT_START;
+
+			*ptr2++ = ' ';
+			for (;;) {
+				state = format_next[state][format_class[(uint8_t)*ptr]];
+				if (!state)
+					break;
+				ptr++;
+				if (format_accept[state])
+					ptr1 = ptr;
+			}
+		} else {
+			*ptr2++ = *ptr1++;
+		}
+	}
+	*ptr2 = '\0';
+}
+
+/*
+ *  Keep a message's format for -m, escapes are turned into
+ *  the characters the kernel would log
+ */
+static void dmesg_format_add(
+	worker_t *RESTRICT w,
+	const char *RESTRICT path,
+	const uint32_t lineno,
+	const char *RESTRICT ptr,
+	const char *RESTRICT end)
+{
+	dmesg_formats_t *d = &w->dmesg;
+	dmesg_format_t *f;
+	char *text, *dst;
+
+	if (UNLIKELY(d->used == d->size)) {
+		const uint32_t size = d->size ? d->size * 2 : DMESG_FORMATS_SIZE;
+		dmesg_format_t *grown = realloc(d->formats, size * sizeof(*grown));
+
+		if (UNLIKELY(!grown))
+			out_of_memory();
+		d->formats = grown;
+		d->size = size;
+	}
+
+	text = dst = arena_alloc(&w->arena, end - ptr + 1);
+	while (ptr < end) {
+		register int ch = (unsigned char)*ptr++;
+
+		if ((ch == '\\') && (ptr < end)) {
+			ch = (unsigned char)*ptr++;
+			switch (ch) {
+			case 'a':
+				ch = '\a';
+				break;
+			case 'b':
+				ch = '\b';
+				break;
+			case 'e':
+				ch = 0x1b;
+				break;
+			case 'f':
+				ch = '\f';
+				break;
+			case 'n':
+				ch = '\n';
+				break;
+			case 'r':
+				ch = '\r';
+				break;
+			case 't':
+				ch = '\t';
+				break;
+			case 'v':
+				ch = '\v';
+				break;
+			case 'x':
+				for (ch = 0; (ptr < end) && isxdigit(*ptr); ptr++)
+					ch = (ch << 4) | (isdigit(*ptr) ? *ptr - '0' : (tolower(*ptr) - 'a' + 10));
+				break;
+			case '0' ... '7': {
+				int n;
+
+				for (ch -= '0', n = 1; (n < 3) && (ptr < end) && (*ptr >= '0') && (*ptr <= '7'); n++)
+					ch = (ch << 3) | (*ptr++ - '0');
+				break;
+			}
+			default:
+				break;
+			}
+		}
+		*dst++ = (char)ch;
+	}
+	*dst = '\0';
+
+	/* a KERN_<LEVEL> marker in the string itself is not logged */
+	if ((text[0] == '\001') && text[1])
+		text += 2;
+
+	f = &d->formats[d->used++];
+	f->path = path;
+	f->text = text;
+	f->len = dst - text;
+	f->lineno = lineno;
+}
+
+/*
+ *  Check if an identifier is a KERN_<LEVEL> log level macro,
+ *  these expand to a level marker with no specifiers
+ */
+static bool kern_level(const char *str, const size_t len)
+{
+	static const char *const levels[] = {
+		"KERN_EMERG",
+		"KERN_ALERT",
+		"KERN_CRIT",
+		"KERN_ERR",
+		"KERN_WARNING",
+		"KERN_NOTICE",
+		"KERN_INFO",
+		"KERN_DEBUG",
+		"KERN_DEFAULT",
+		"KERN_CONT",
+	};
+	size_t i;
+
+	if ((len < 5) || strncmp(str, "KERN_", 5))
+		return false;
+	for (i = 0; i < SIZEOF_ARRAY(levels); i++) {
+		if ((strlen(levels[i]) == len) && !strncmp(levels[i], str, len))
+			return true;
+	}
+	return false;
+}
+
+/*
+ *  Count the arguments a kernel format string consumes, each
+ *  specifier is parsed as the kernel's vsprintf format_decode()
+ *  does: flags, a width and a precision that may each be a '*'
+ *  taking an argument, a length qualifier and the conversion.
+ *  %p extensions are the alphanumerics after the p. Returns -1
+ *  if a specifier is invalid as the kernel stops there and the
+ *  count would not mean anything
+ */
+static int format_args(register const char *ptr, const char *const end)
+{
+	int args = 0;
+
+	while ((ptr = memchr(ptr, '%', end - ptr)) != NULL) {
+		if (++ptr >= end)
+			return -1;
+		if (*ptr == '%') {
+			ptr++;
+			continue;
+		}
+		while ((ptr < end) && strchr("-+ #0", *ptr))
+			ptr++;
+		if ((ptr < end) && (*ptr == '*')) {
+			args++;
+			ptr++;
+		} else {
+			while ((ptr < end) && isdigit(*ptr))
+				ptr++;
+		}
+		if ((ptr < end) && (*ptr == '.')) {
+			ptr++;
+			if ((ptr < end) && (*ptr == '*')) {
+				args++;
+				ptr++;
+			} else {
+				while ((ptr < end) && isdigit(*ptr))
+					ptr++;
+			}
+		}
+		if ((ptr < end) && strchr("hlLzZt", *ptr)) {
+			if ((ptr + 1 < end) && (ptr[1] == ptr[0]) && ((*ptr == 'h') || (*ptr == 'l')))
+				ptr++;
+			ptr++;
+		}
+		if (ptr >= end)
+			return -1;
+		switch (*ptr++) {
+		case 'p':
+			while ((ptr < end) && isalnum(*ptr))
+				ptr++;
+			/* fall through */
+		case 'c':
+		case 's':
+		case 'd':
+		case 'i':
+		case 'o':
+		case 'u':
+		case 'x':
+		case 'X':
+			args++;
+			break;
+		default:
+			return -1;
+		}
+	}
+	return args;
+}
+
+/*
+ *  Parse a kernel message, like printk() or dev_err()
+ */
+static get_char_t HOT TARGET_CLONES parse_kernel_message(
+	worker_t *RESTRICT w,
+	const char *RESTRICT path,
+	const unsigned char *start,
+	bool *RESTRICT source_emit,
+	parser_t *RESTRICT p)
+{
+	token_t *RESTRICT t = &w->t;
+	token_t *RESTRICT line = &w->line;
+	token_t *RESTRICT str = &w->str;
+	bool got_string = false;
+	bool emit = false;
+	bool found = false;
+	bool nl = false;
+	bool check_nl = ((opt_flags & OPT_MISSING_NEWLINE) != 0);
+	bool check_format = ((opt_flags & OPT_CHECK_FORMAT) != 0);
+	bool gather_format = ((opt_flags & (OPT_CHECK_FORMAT | OPT_DMESG)) != 0);
+	token_t *RESTRICT format = &w->format;
+	uint32_t depth = 1;		/* (, [ and { nesting, 0 once the call closes */
+	uint32_t arg = 0;		/* top level argument being parsed */
+	int32_t format_arg = -1;	/* argument holding the format string */
+	bool format_ok = true;		/* format is just literal strings */
+	bool args_ok = true;		/* top level commas are the arguments */
+	uint32_t dots = 0;		/* consecutive . tokens, 3 is ... */
+	bool macro = false;		/* argument has an identifier before any literal */
+	int need = 0;			/* arguments the format consumes */
+	uint32_t lineno, column;	/* where the message starts */
+
+	token_clear(line);
+
+	token_cat(line, t);
+	token_clear(t);
+	if (UNLIKELY(get_token(p, t) == PARSER_EOF)) {
+		return PARSER_EOF;
+	}
+	if (t->type != TOKEN_PAREN_OPENED) {
+		for (;;) {
+			if (UNLIKELY(get_token(p, t) == PARSER_EOF))
+				return PARSER_EOF;
+			if (t->type == TOKEN_TERMINAL)
+				break;
+		}
+		token_clear(t);
+		return PARSER_OK;
+	}
+	token_cat(line, t);
+	token_clear(t);
+
+	token_clear(str);
+	if (gather_format)
+		token_clear(format);
+	for (;;) {
+		get_char_t ret = get_token(p, t);
+
+		if (UNLIKELY(ret == PARSER_EOF))
+			return PARSER_EOF;
+
+		/*
+		 *  Hit ; so lets push out what we've parsed
+		 */
+		if (t->type == TOKEN_TERMINAL) {
+			if (check_nl & nl) {
+				emit = false;
+			}
+			if (opt_flags & OPT_DMESG) {
+				/* just keep the format, nothing is printed */
+				if (format_ok && (format_arg >= 0)) {
+					newline_index_find(&w->newlines, start, &lineno, &column);
+					dmesg_format_add(w, path, lineno, format->token, format->ptr);
+					w->finds++;
+				}
+				emit = false;
+			} else if (check_format) {
+				/*
+				 *  Only messages whose format can be followed and
+				 *  that don't get the arguments it asks for
+				 */
+				if (format_ok && args_ok && (format_arg >= 0) && !depth) {
+					need = format_args(format->token, format->ptr);
+					if ((need < 0) || ((uint32_t)need == arg - format_arg))
+						emit = false;
+				} else {
+					emit = false;
+				}
+			}
+			if (emit) {
+				if (opt_flags & OPT_CHECK_WORDS)
+					check_words(w, line);
+				else {
+					char *ptr;
+					if (! *source_emit) {
+						if (opt_flags & OPT_SOURCE_NAME) {
+							token_cat_str(&w->out, "Source: ");
+							token_cat_str(&w->out, path);
+							token_cat_str(&w->out, "\n");
+						}
+						*source_emit = true;
+					}
+					if (opt_flags & OPT_POSITION) {
+						const scope_t *s = &p->scope;
+						char buf[32];
+
+						newline_index_find(&w->newlines, start, &lineno, &column);
+						token_cat_str(&w->out, path);
+						(void)snprintf(buf, sizeof(buf), ":%" PRIu32 ":%" PRIu32 ":",
+							lineno, column);
+						token_cat_str(&w->out, buf);
+						if (s->function) {
+							token_cat_str(&w->out, space);
+							token_append_str(&w->out, (const char *)s->function, s->function_len);
+							token_cat_str(&w->out, "():");
+						}
+					}
+					if (opt_flags & OPT_FORMAT_STRIP)
+						strip_format(line->token);
+
+					for (ptr = line->token; isblank(*ptr); ptr++)
+						;
+
+					token_cat_str(&w->out, space);
+					token_cat_str(&w->out, ptr);
+					if (check_format) {
+						char buf[64];
+
+						(void)snprintf(buf, sizeof(buf), "%s  [%d format arguments, %" PRIu32 " given]\n",
+							(opt_flags & OPT_LITERAL_STRINGS) ? "" : ";",
+							need, arg - format_arg);
+						token_cat_str(&w->out, buf);
+					} else {
+						token_cat_str(&w->out, (opt_flags & OPT_LITERAL_STRINGS) ? "\n" : ";\n");
+					}
+				}
+				if (check_format)
+					w->format_mismatches++;
+				w->finds++;
+			}
+			token_clear(t);
+			return PARSER_OK;
+		}
+
+		if (gather_format && depth && (t->type != TOKEN_WHITE_SPACE)) {
+			/*
+			 *  The format is the first top level argument with a
+			 *  literal string. Identifiers other than KERN_ERR and
+			 *  friends could be macros hiding specifiers, so the
+			 *  argument count is not checked. Arguments are counted
+			 *  by top level commas
+			 */
+			dots = (*t->token == '.') ? dots + 1 : 0;
+			switch (t->type) {
+			case TOKEN_LITERAL_STRING:
+				if ((format_arg < 0) && (depth == 1)) {
+					format_arg = arg;
+					args_ok &= !macro;
+				} else if ((uint32_t)format_arg != arg)
+					break;
+				if (depth == 1)
+					token_append_str(format, t->token + 1, token_len(t) > 1 ? token_len(t) - 2 : 0);
+				else
+					format_ok = false;
+				break;
+			case TOKEN_PAREN_OPENED:
+			case TOKEN_SQUARE_OPENED:
+				depth++;
+				format_ok &= ((uint32_t)format_arg != arg);
+				break;
+			case TOKEN_PAREN_CLOSED:
+			case TOKEN_SQUARE_CLOSED:
+				depth--;
+				break;
+			case TOKEN_COMMA:
+				if (depth == 1) {
+					arg++;
+					macro = false;
+				}
+				break;
+			case TOKEN_IDENTIFIER:
+				if (kern_level(t->token, token_len(t)))
+					break;
+				if ((uint32_t)format_arg == arg)
+					format_ok = false;
+				else if ((token_len(t) == 11) && !strncmp(t->token, "__VA_ARGS__", 11))
+					args_ok = false;
+				else if ((token_len(t) > 8) && !strncmp(t->ptr - 8, "_pr_args", 8))
+					args_ok = false;	/* cpumask_pr_args() etc are two arguments */
+				else if ((format_arg < 0) && (depth == 1))
+					macro = true;
+				break;
+			default:
+				if (*t->token == '{')
+					depth++;
+				else if (*t->token == '}')
+					depth--;
+				else if ((dots == 3) && (depth == 1))
+					args_ok = false;	/* ... */
+				format_ok &= ((uint32_t)format_arg != arg);
+				break;
+			}
+		}
+
+		if (t->type == TOKEN_LITERAL_STRING) {
+			literal_strip_quotes(t);
+			token_cat(str, t);
+
+			if (!got_string)
+				token_cat_str(line, quotes);
+
+			got_string = true;
+			emit = true;
+		} else {
+			if (got_string) {
+				register size_t len = token_len(line);
+
+				if ((check_nl) &&
+				    (len > 2) &&
+				    (line->token[len - 3] == '\\') &&
+				    (line->token[len - 2] == 'n')) {
+					nl = true;
+				}
+				token_cat_str(line, quotes);
+			}
+			got_string = false;
+
+			if (token_len(str)) {
+				found |= true;
+				token_clear(str);
+			}
+		}
+
+		token_cat(line, t);
+		if (t->type == TOKEN_COMMA)
+			token_cat_str(line, space);
+
+		token_clear(t);
+	}
+}
+
+/*
+ *  Skip over a comment, matching skip_comments(), a lone
+ *  slash is skipped by itself
+ */
+static inline unsigned char HOT *scan_comment(
+	register unsigned char *ptr,
+	register unsigned char *const data_end)
+{
+	if (UNLIKELY(ptr + 1 >= data_end))
+		return data_end;
+
+	if (ptr[1] == '/') {
+		ptr = memchr(ptr + 2, '\n', data_end - (ptr + 2));
+		return ptr ? ptr + 1 : data_end;
+	}
+	if (ptr[1] == '*') {
+		ptr = scan_comment_end(ptr + 2, data_end);
+		return ptr ? ptr : data_end;
+	}
+	return ptr + 1;
+}
+
+/*
+ *  Skip over a pre-processor line, matching skip_macros()
+ */
+static inline unsigned char HOT *scan_macro(
+	register unsigned char *ptr,
+	register unsigned char *const data_end)
+{
+	ptr = scan_macro_end(ptr + 1, data_end);
+
+	return ptr ? ptr : data_end;
+}
+
+/*
+ *  Find the end of a number at the start of a run of
+ *  identifier characters, matching parse_number()
+ */
+static inline unsigned char HOT *scan_number(
+	register unsigned char *ptr,
+	register const unsigned char *const end)
+{
+	if (*ptr == '0') {
+		ptr++;
+		if (ptr >= end)
+			return ptr;
+		if (*ptr >= '0' && *ptr <= '8') {
+			while ((ptr < end) && (*ptr >= '0' && *ptr <= '8'))
+				ptr++;
+		} else if (((*ptr == 'x') || (*ptr == 'X')) &&
+			   (ptr + 1 < end) && isxdigit(ptr[1])) {
+			for (ptr += 2; (ptr < end) && isxdigit(*ptr); ptr++)
+				;
+		}
+		return ptr;
+	}
+	while ((ptr < end) && isdigit(*ptr))
+		ptr++;
+	return ptr;
+}
+
+/*
+ *  A run of identifier characters lexes as numbers followed
+ *  by an identifier up to the end of the run, return the
+ *  identifier if it is a printk like function name
+ */
+static inline unsigned char HOT *scan_printk(
+	register unsigned char *ptr,
+	register unsigned char *const end)
+{
+	while (UNLIKELY(isdigit(*ptr))) {
+		ptr = scan_number(ptr, end);
+		if (ptr >= end)
+			return NULL;
+	}
+
+	return printk_find((char *)ptr, end - ptr) ? ptr : NULL;
+}
+
+/*
+ *  Prefilter the raw input for the next printk like function
+ *  name.  This tracks comments, literals and macros the same
+ *  way the lexer does so the name found is exactly where the
+ *  lexer would find it and the lexer can be restarted there.
+ *  Given a scope, braces and semicolons are tracked as the
+ *  lexer tracks them.
+ *
+ *  Each block is indexed by scan_index() and the scan jumps
+ *  between the structural characters, the starts of identifiers,
+ *  quotes, slashes and hashes, rather than visiting every byte.
+ *  Returns NULL if there are no more printk like names.
+ */
+static unsigned char HOT *scan_printks(
+	register unsigned char *ptr,
+	register unsigned char *const data_end,
+	scope_t *RESTRICT scope)
+{
+	while (LIKELY(ptr < data_end)) {
+		scan_block_t b;
+		uint64_t starts, structural;
+		unsigned char *next = ptr + SCAN_BLOCK_SIZE;
+
+		scan_index(ptr, data_end, &b);
+		starts = b.identifier & ~(b.identifier << 1);
+		structural = starts | b.quote | b.apostrophe | b.slash | b.hash;
+		if (scope)
+			structural |= b.brace_opened | b.brace_closed | b.semicolon;
+
+		while (structural) {
+			const uint32_t bit = __builtin_ctzll(structural);
+			const uint64_t mask = 1ULL << bit;
+			unsigned char *const start = ptr + bit;
+
+			if (starts & mask) {
+				const uint64_t end = ~b.identifier >> bit;
+				unsigned char *found;
+
+				if (LIKELY(end)) {
+					next = start + __builtin_ctzll(end);
+				} else {
+					next = ptr + SCAN_BLOCK_SIZE;
+					while ((next < data_end) && !is_not_identifier[*next])
+						next++;
+				}
+				found = scan_printk(start, next);
+				if (UNLIKELY(found != NULL))
+					return found;
+				if (scope && !scope->depth)
+					scope_name(scope, start, next, data_end);
+			} else {
+				if ((b.quote | b.apostrophe) & mask)
+					next = scan_literal(start, data_end);
+				else if (b.slash & mask)
+					next = scan_comment(start, data_end);
+				else if (b.hash & mask)
+					next = scan_macro(start, data_end);
+				else {
+					if (b.brace_opened & mask)
+						scope_enter(scope);
+					else if (b.brace_closed & mask)
+						scope_leave(scope);
+					else
+						scope_terminal(scope);
+					next = start + 1;
+				}
+
+			}
+
+			/* Jumped out of the block, index the next one from there */
+			if (next - ptr >= SCAN_BLOCK_SIZE)
+				goto next_block;
+
+			structural &= ~0ULL << (next - ptr);
+		}
+		if (data_end - ptr <= SCAN_BLOCK_SIZE)
+			break;
+		next = ptr + SCAN_BLOCK_SIZE;
+next_block:
+		ptr = next;
+	}
+	return NULL;
+}
+
+/*
+ *  Parse input looking for printk like function calls, the
+ *  prefilter skips to each printk like name and the lexer
+ *  just parses the message that follows it
+ */
+static void parse_kernel_messages(
+	worker_t *RESTRICT w,
+	const char *RESTRICT path,
+	unsigned char *RESTRICT data,
+	unsigned char *RESTRICT data_end)
+{
+	token_t *RESTRICT t = &w->t;
+	parser_t p;
+
+	parser_new(&p, data, data_end, true);
+	bool source_emit = false;
+	scope_t *scope = (opt_flags & OPT_POSITION) ? &p.scope : NULL;
+
+	token_clear(t);
+	w->lines += newline_index_reset(&w->newlines, data, data_end);
+
+	while ((p.ptr = scan_printks(p.ptr, data_end, scope)) != NULL) {
+		const unsigned char *start = p.ptr;
+
+		if (UNLIKELY(get_token(&p, t) == PARSER_EOF))
+			break;
+		if ((t->type == TOKEN_IDENTIFIER) &&
+		    (printk_find(t->token, token_len(t)))) {
+			if (parse_kernel_message(w, path, start,
+						 &source_emit, &p) == PARSER_EOF)
+				break;
+			//source_emit = true;
+		}
+		token_clear(t);
+	}
+
+	if (opt_flags & OPT_CHECK_WORDS)
+		return;
+	if (source_emit && (opt_flags & OPT_SOURCE_NAME))
+		token_cat_str(&w->out, "\n");
+}
+
+/*
+ *  Parse input looking for literal strings
+ */
+static void parse_literal_strings(
+	worker_t *RESTRICT w,
+	const char *RESTRICT path,
+	unsigned char *RESTRICT data,
+	unsigned char *RESTRICT data_end)
+{
+	token_t *RESTRICT t = &w->t;
+	parser_t p;
+
+	(void)path;
+
+	parser_new(&p, data, data_end, true);
+
+	token_clear(t);
+
+	while ((get_token(&p, t)) != PARSER_EOF) {
+		if (t->type == TOKEN_LITERAL_STRING)
+			check_words(w, t);
+		token_clear(t);
+	}
+	w->lines += count_newlines(data, data_end);
+}
+
+/*
+ *  Compiled -m lookup engine, the formats of every message found,
+ *  the matchers compiled from them and an Aho-Corasick automaton
+ *  over the longest literal fragment of each matcher
+ */
+static dmesg_format_t *dmesg_formats;
+static dmesg_op_t *dmesg_ops;
+static dmesg_matcher_t *dmesg_matchers;
+static dmesg_node_t *dmesg_nodes;
+static uint32_t dmesg_root_next[256];
+static uint32_t dmesg_n_formats;
+static uint32_t dmesg_n_ops;
+static uint32_t dmesg_n_matchers;
+
+static int dmesg_format_cmp(const void *p1, const void *p2)
+{
+	const dmesg_format_t *f1 = (const dmesg_format_t *)p1;
+	const dmesg_format_t *f2 = (const dmesg_format_t *)p2;
+	int ret = strcmp(f1->path, f2->path);
+
+	if (ret)
+		return ret;
+	if (f1->lineno != f2->lineno)
+		return f1->lineno < f2->lineno ? -1 : 1;
+	return strcmp(f1->text, f2->text);
+}
+
+static int dmesg_fragment_cmp(const void *p1, const void *p2)
+{
+	const dmesg_matcher_t *m1 = &dmesg_matchers[*(const uint32_t *)p1];
+	const dmesg_matcher_t *m2 = &dmesg_matchers[*(const uint32_t *)p2];
+	const uint32_t len = m1->fragment_len < m2->fragment_len ?
+		m1->fragment_len : m2->fragment_len;
+	int ret = memcmp(m1->fragment, m2->fragment, len);
+
+	if (ret)
+		return ret;
+	if (m1->fragment_len != m2->fragment_len)
+		return m1->fragment_len < m2->fragment_len ? -1 : 1;
+	return *(const uint32_t *)p1 < *(const uint32_t *)p2 ? -1 : 1;
+}
+
+/*
+ *  Add a step to the matcher being compiled
+ */
+static void dmesg_op_add(
+	uint32_t *RESTRICT size,
+	const dmesg_op_type_t type,
+	const char *RESTRICT str,
+	const uint32_t len)
+{
+	if (UNLIKELY(dmesg_n_ops == *size)) {
+		dmesg_op_t *ops;
+
+		*size = *size ? *size * 2 : 4096;
+		ops = realloc(dmesg_ops, *size * sizeof(*ops));
+		if (UNLIKELY(!ops))
+			out_of_memory();
+		dmesg_ops = ops;
+	}
+	dmesg_ops[dmesg_n_ops].type = type;
+	dmesg_ops[dmesg_n_ops].str = str;
+	dmesg_ops[dmesg_n_ops].len = len;
+	dmesg_n_ops++;
+}
+
+/*
+ *  Compile one line of a format, from ptr to end, into a
+ *  matcher. Specifiers are parsed as format_args() parses
+ *  them and become typed wildcards, everything else is
+ *  literal text. Returns false if no literal text is long
+ *  enough to index the matcher by
+ */
+static bool dmesg_compile(
+	dmesg_matcher_t *RESTRICT m,
+	uint32_t *RESTRICT ops_size,
+	const char *ptr,
+	const char *const end)
+{
+	const char *literal = ptr;
+	uint32_t i;
+
+	m->op = dmesg_n_ops;
+	while (ptr < end) {
+		dmesg_op_type_t type;
+
+		if ((*ptr != '%') || (ptr + 1 >= end)) {
+			ptr++;
+			continue;
+		}
+		if (ptr > literal)
+			dmesg_op_add(ops_size, DMESG_LITERAL, literal, ptr - literal);
+		if (*++ptr == '%') {
+			literal = ptr++;
+			continue;
+		}
+		while ((ptr < end) && (strchr("-+ #0*.", *ptr) || isdigit(*ptr)))
+			ptr++;
+		while ((ptr < end) && strchr("hlLzZt", *ptr))
+			ptr++;
+		if (ptr >= end)
+			break;
+		switch (*ptr++) {
+		case 'd':
+		case 'i':
+			type = DMESG_SIGNED;
+			break;
+		case 'u':
+			type = DMESG_UNSIGNED;
+			break;
+		case 'x':
+		case 'X':
+			type = DMESG_HEX;
+			break;
+		case 'o':
+			type = DMESG_OCTAL;
+			break;
+		case 'c':
+			type = DMESG_CHAR;
+			break;
+		case 'p':
+			while ((ptr < end) && isalnum(*ptr))
+				ptr++;
+			/* fall through */
+		default:
+			type = DMESG_ANY;
+			break;
+		}
+		dmesg_op_add(ops_size, type, NULL, 0);
+		literal = ptr;
+	}
+	if (end > literal)
+		dmesg_op_add(ops_size, DMESG_LITERAL, literal, end - literal);
+	m->n_ops = dmesg_n_ops - m->op;
+
+	m->fragment = NULL;
+	m->fragment_len = 0;
+	for (i = m->op; i < dmesg_n_ops; i++) {
+		if ((dmesg_ops[i].type == DMESG_LITERAL) &&
+		    (dmesg_ops[i].len > m->fragment_len)) {
+			m->fragment_op = i - m->op;
+			m->fragment = dmesg_ops[i].str;
+			m->fragment_len = dmesg_ops[i].len;
+		}
+	}
+	if (m->fragment_len > DMESG_FRAGMENT_MAX)
+		m->fragment_len = DMESG_FRAGMENT_MAX;
+
+	return m->fragment_len >= DMESG_FRAGMENT_MIN;
+}
+
+/*
+ *  Gather the workers' formats and compile a matcher for each
+ *  line of each of them. Lines end at a '\n' in the format,
+ *  they are anchored at the end of the log line unless they
+ *  are the last line of a format without a trailing '\n' as
+ *  more may be added to them with pr_cont()
+ */
+static void dmesg_compile_formats(void)
+{
+	uint32_t i, n = 0, ops_size = 0, size = 0;
+
+	for (i = 0; i < jobs; i++)
+		n += workers[i].dmesg.used;
+	dmesg_formats = malloc((n ? n : 1) * sizeof(*dmesg_formats));
+	if (UNLIKELY(!dmesg_formats))
+		out_of_memory();
+	for (i = 0; i < jobs; i++) {
+		const dmesg_formats_t *d = &workers[i].dmesg;
+
+		if (d->used)
+			__builtin_memcpy(dmesg_formats + dmesg_n_formats, d->formats,
+				d->used * sizeof(*dmesg_formats));
+		dmesg_n_formats += d->used;
+	}
+	/* same order however the files were shared between workers */
+	qsort(dmesg_formats, dmesg_n_formats, sizeof(*dmesg_formats), dmesg_format_cmp);
+
+	for (i = 0; i < dmesg_n_formats; i++) {
+		const char *ptr = dmesg_formats[i].text;
+		const char *const end = ptr + dmesg_formats[i].len;
+
+		while (ptr < end) {
+			const char *eol = memchr(ptr, '\n', end - ptr);
+			dmesg_matcher_t *m;
+
+			if (dmesg_n_matchers == size) {
+				size = size ? size * 2 : 4096;
+				m = realloc(dmesg_matchers, size * sizeof(*m));
+				if (UNLIKELY(!m))
+					out_of_memory();
+				dmesg_matchers = m;
+			}
+			m = &dmesg_matchers[dmesg_n_matchers];
+			m->format = i;
+			m->anchored = (eol != NULL);
+			if (!eol)
+				eol = end;
+			if (eol > ptr) {
+				if (dmesg_compile(m, &ops_size, ptr, eol)) {
+					dmesg_n_matchers++;
+					dmesg_indexed++;
+				} else {
+					dmesg_n_ops = m->op;
+					dmesg_unindexed++;
+				}
+			}
+			ptr = eol + 1;
+		}
+	}
+}
+
+/*
+ *  Child of node with the given label, DMESG_NONE if there
+ *  is none. Children are in label order
+ */
+static inline uint32_t HOT dmesg_child(const dmesg_node_t *RESTRICT node, const uint8_t label)
+{
+	register uint32_t lo = node->children, hi = lo + node->n_children;
+
+	while (lo < hi) {
+		register const uint32_t mid = (lo + hi) >> 1;
+
+		if (dmesg_nodes[mid].label < label)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return ((lo < node->children + node->n_children) &&
+		(dmesg_nodes[lo].label == label)) ? lo : DMESG_NONE;
+}
+
+/*
+ *  Build the automaton over the matchers' fragments. With the
+ *  fragments sorted the trie is built breadth first, each node
+ *  owns a range of the sorted fragments and its children are
+ *  allocated together as the range is split on the next
+ *  character, so nodes come out in breadth first order and
+ *  the failure links can be set in the same order
+ */
+static void dmesg_build(void)
+{
+	uint32_t *order, *lo, *hi, *depth;
+	uint32_t i, n, n_nodes = 1;
+	size_t max_nodes = 1;
+
+	for (i = 0; i < dmesg_n_matchers; i++)
+		max_nodes += dmesg_matchers[i].fragment_len;
+	dmesg_nodes = calloc(max_nodes, sizeof(*dmesg_nodes));
+	order = malloc((dmesg_n_matchers + 1) * sizeof(*order));
+	lo = malloc(max_nodes * sizeof(*lo));
+	hi = malloc(max_nodes * sizeof(*hi));
+	depth = malloc(max_nodes * sizeof(*depth));
+	if (UNLIKELY(!dmesg_nodes || !order || !lo || !hi || !depth))
+		out_of_memory();
+
+	for (i = 0; i < dmesg_n_matchers; i++)
+		order[i] = i;
+	qsort(order, dmesg_n_matchers, sizeof(*order), dmesg_fragment_cmp);
+
+	lo[DMESG_ROOT] = 0;
+	hi[DMESG_ROOT] = dmesg_n_matchers;
+	depth[DMESG_ROOT] = 0;
+	for (n = 0; n < n_nodes; n++) {
+		dmesg_node_t *node = &dmesg_nodes[n];
+		uint32_t j = lo[n], *tail = &node->matchers;
+
+		/* fragments ending here sort first */
+		node->matchers = DMESG_NONE;
+		while ((j < hi[n]) && (dmesg_matchers[order[j]].fragment_len == depth[n])) {
+			*tail = order[j];
+			tail = &dmesg_matchers[order[j]].next;
+			j++;
+		}
+		*tail = DMESG_NONE;
+
+		node->children = n_nodes;
+		while (j < hi[n]) {
+			const uint8_t label = dmesg_matchers[order[j]].fragment[depth[n]];
+			dmesg_node_t *child = &dmesg_nodes[n_nodes];
+
+			child->label = label;
+			lo[n_nodes] = j;
+			while ((j < hi[n]) && ((uint8_t)dmesg_matchers[order[j]].fragment[depth[n]] == label))
+				j++;
+			hi[n_nodes] = j;
+			depth[n_nodes] = depth[n] + 1;
+			n_nodes++;
+		}
+		node->n_children = n_nodes - node->children;
+	}
+
+	for (i = 0; i < 256; i++)
+		dmesg_root_next[i] = DMESG_ROOT;
+	dmesg_nodes[DMESG_ROOT].fail = DMESG_ROOT;
+	dmesg_nodes[DMESG_ROOT].output = DMESG_NONE;
+	for (n = 0; n < n_nodes; n++) {
+		const dmesg_node_t *node = &dmesg_nodes[n];
+
+		for (i = node->children; i < node->children + node->n_children; i++) {
+			dmesg_node_t *child = &dmesg_nodes[i];
+			uint32_t fail = DMESG_ROOT;
+
+			if (n == DMESG_ROOT) {
+				dmesg_root_next[child->label] = i;
+			} else {
+				uint32_t f = node->fail;
+
+				for (;;) {
+					const uint32_t next = dmesg_child(&dmesg_nodes[f], child->label);
+
+					if (next != DMESG_NONE) {
+						fail = next;
+						break;
+					}
+					if (f == DMESG_ROOT)
+						break;
+					f = dmesg_nodes[f].fail;
+				}
+			}
+			child->fail = fail;
+			child->output = (dmesg_nodes[fail].matchers != DMESG_NONE) ?
+				fail : dmesg_nodes[fail].output;
+		}
+	}
+	dmesg_nodes_used = n_nodes;
+
+	free(depth);
+	free(hi);
+	free(lo);
+	free(order);
+}
+
+/*
+ *  Skip a number of at least one digit in the given base,
+ *  returns NULL if there is none
+ */
+static inline const char *dmesg_digits(
+	register const char *ptr,
+	const char *const end,
+	const int base)
+{
+	register const char *start = ptr;
+
+	while ((ptr < end) &&
+	       ((base == 16) ? isxdigit(*ptr) :
+		((*ptr >= '0') && (*ptr < '0' + base))))
+		ptr++;
+
+	return (ptr > start) ? ptr : NULL;
+}
+
+static bool dmesg_match_any(const dmesg_op_t *op, const dmesg_op_t *op_end,
+	const char *ptr, const char *const end, const bool anchored);
+
+/*
+ *  Match the steps from op against the log text from ptr
+ */
+static bool dmesg_match(
+	register const dmesg_op_t *op,
+	const dmesg_op_t *op_end,
+	register const char *ptr,
+	const char *const end,
+	const bool anchored)
+{
+	for (; op < op_end; op++) {
+		switch (op->type) {
+		case DMESG_LITERAL:
+			if (((size_t)(end - ptr) < op->len) ||
+			    __builtin_memcmp(ptr, op->str, op->len))
+				return false;
+			ptr += op->len;
+			break;
+		case DMESG_CHAR:
+			if (ptr >= end)
+				return false;
+			ptr++;
+			break;
+		case DMESG_ANY:
+			return dmesg_match_any(op + 1, op_end, ptr, end, anchored);
+		default:
+			/* numbers may be padded out to a width */
+			while ((ptr < end) && (*ptr == ' '))
+				ptr++;
+			if ((op->type == DMESG_SIGNED) && (ptr < end) &&
+			    ((*ptr == '-') || (*ptr == '+')))
+				ptr++;
+			if ((op->type == DMESG_HEX) && (end - ptr > 2) &&
+			    (ptr[0] == '0') && ((ptr[1] == 'x') || (ptr[1] == 'X')))
+				ptr += 2;
+			ptr = dmesg_digits(ptr, end,
+				(op->type == DMESG_HEX) ? 16 : ((op->type == DMESG_OCTAL) ? 8 : 10));
+			if (!ptr)
+				return false;
+			break;
+		}
+	}
+	return !anchored || (ptr == end);
+}
+
+/*
+ *  Match any run of characters from ptr followed by the steps
+ *  from op, trying each place the next literal text starts
+ */
+static bool dmesg_match_any(
+	const dmesg_op_t *op,
+	const dmesg_op_t *op_end,
+	const char *ptr,
+	const char *const end,
+	const bool anchored)
+{
+	if (op == op_end)
+		return true;
+	if (op->type == DMESG_LITERAL) {
+		while ((ptr = memchr(ptr, op->str[0], end - ptr)) != NULL) {
+			if (dmesg_match(op, op_end, ptr, end, anchored))
+				return true;
+			ptr++;
+		}
+		return false;
+	}
+	for (; ptr <= end; ptr++)
+		if (dmesg_match(op, op_end, ptr, end, anchored))
+			return true;
+	return false;
+}
+
+/*
+ *  Match a line against a matcher whose fragment was found at
+ *  ptr. The steps from the fragment on must match from there,
+ *  which mostly fails on the first compare, and the steps
+ *  before it must end where the fragment starts
+ */
+static inline bool HOT dmesg_match_at(
+	const dmesg_matcher_t *RESTRICT m,
+	const char *line,
+	const char *ptr,
+	const char *const end)
+{
+	const dmesg_op_t *ops = dmesg_ops + m->op;
+	const dmesg_op_t *fragment_op = ops + m->fragment_op;
+
+	return dmesg_match(fragment_op, ops + m->n_ops, ptr, end, m->anchored) &&
+	       dmesg_match_any(ops, fragment_op, line, ptr, true);
+}
+
+/*
+ *  Map each line of a kernel log back to the source lines of
+ *  the messages that could have printed it. The automaton finds
+ *  the indexed fragments in the line in one pass and just the
+ *  matchers of those fragments are tried where the fragment
+ *  was found, so the cost per line does not grow with the
+ *  number of formats
+ */
+static void dmesg_lookup(const char *path)
+{
+	uint32_t *seen, stamp = 0;
+	struct stat statbuf;
+	char *data;
+	const char *ptr, *data_end;
+	int fd;
+
+	dmesg_compile_formats();
+	dmesg_build();
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		fprintf(stderr, "Cannot open %s, errno=%d (%s)\n",
+			path, errno, strerror(errno));
+		return;
+	}
+	if (fstat(fd, &statbuf) < 0) {
+		fprintf(stderr, "Cannot stat %s, errno=%d (%s)\n",
+			path, errno, strerror(errno));
+		(void)close(fd);
+		return;
+	}
+	if (!statbuf.st_size) {
+		(void)close(fd);
+		return;
+	}
+	data = mmap(NULL, statbuf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	(void)close(fd);
+	if (data == MAP_FAILED) {
+		fprintf(stderr, "Cannot mmap %s, errno=%d (%s)\n",
+			path, errno, strerror(errno));
+		return;
+	}
+	(void)madvise(data, statbuf.st_size, MADV_SEQUENTIAL);
+
+	seen = calloc(dmesg_n_formats + 1, sizeof(*seen));
+	if (UNLIKELY(!seen))
+		out_of_memory();
+
+	data_end = data + statbuf.st_size;
+	for (ptr = data; ptr < data_end; ) {
+		const char *eol = memchr(ptr, '\n', data_end - ptr);
+		const char *line = ptr, *end, *p;
+		register uint32_t state = DMESG_ROOT;
+		bool matched = false;
+
+		if (!eol)
+			eol = data_end;
+		ptr = eol + 1;
+		end = eol;
+		if ((end > line) && (end[-1] == '\r'))
+			end--;
+		dmesg_lines++;
+		stamp++;
+
+		for (p = line; p < end; p++) {
+			const uint8_t ch = (uint8_t)*p;
+			uint32_t o;
+
+			for (;;) {
+				uint32_t next;
+
+				if (state == DMESG_ROOT) {
+					state = dmesg_root_next[ch];
+					break;
+				}
+				next = dmesg_child(&dmesg_nodes[state], ch);
+				if (next != DMESG_NONE) {
+					state = next;
+					break;
+				}
+				state = dmesg_nodes[state].fail;
+			}
+
+			o = (dmesg_nodes[state].matchers != DMESG_NONE) ?
+				state : dmesg_nodes[state].output;
+			for (; o != DMESG_NONE; o = dmesg_nodes[o].output) {
+				uint32_t i;
+
+				for (i = dmesg_nodes[o].matchers; i != DMESG_NONE; i = dmesg_matchers[i].next) {
+					const dmesg_matcher_t *m = &dmesg_matchers[i];
+					const dmesg_format_t *f = &dmesg_formats[m->format];
+
+					if ((seen[m->format] == stamp) ||
+					    !dmesg_match_at(m, line, p + 1 - m->fragment_len, end))
+						continue;
+					seen[m->format] = stamp;
+					matched = true;
+					printf("%s:%" PRIu32 ": %.*s\n", f->path, f->lineno,
+						(int)(end - line), line);
+				}
+			}
+		}
+		dmesg_lines_matched += matched;
+	}
+
+	free(seen);
+	(void)munmap(data, statbuf.st_size);
+	free(dmesg_nodes);
+	free(dmesg_matchers);
+	free(dmesg_ops);
+	free(dmesg_formats);
+}
+
+static void show_usage(void)
+{
+	fprintf(stderr, "kernelscan: the fast kernel source message scanner\n\n");
+	fprintf(stderr, "kernelscan [options] path\n");
+	fprintf(stderr, "  -a       find messages with the wrong number of format arguments\n");
+	fprintf(stderr, "  -c       check words in dictionary\n");
+	fprintf(stderr, "  -d file  specify dictionary word list or dictionary image\n");
+	fprintf(stderr, "  -e       strip out C escape sequences\n");
+	fprintf(stderr, "  -f       replace kernel %% format specifiers with a space\n");
+	fprintf(stderr, "  -h       show this help\n");
+	fprintf(stderr, "  -j N     parse files using N threads\n");
+	fprintf(stderr, "  -k       same as -ceflsx\n");
+	fprintf(stderr, "  -l       scan all literal strings and not print statements\n");
+	fprintf(stderr, "  -m log   map dmesg log lines back to the messages' source lines\n");
+	fprintf(stderr, "  -n       find messages with missing \\n newline\n");
+	fprintf(stderr, "  -p       prefix messages with file:line:column: and function\n");
+	fprintf(stderr, "  -r N     read files up to N bytes rather than mmap them\n");
+	fprintf(stderr, "  -s       just print literal strings\n");
+	fprintf(stderr, "  -u       read files using io_uring if available\n");
+	fprintf(stderr, "  -w N     walk directories using N threads\n");
+	fprintf(stderr, "  -x       exclude the source file name from the output\n");
+	fprintf(stderr, "  --compile-dict in out.img\n");
+	fprintf(stderr, "           compile word list in to dictionary image out.img\n");
+	fprintf(stderr, "  --dict-benchmark\n");
+	fprintf(stderr, "           report dictionary lookups per second for a word list\n");
+}
+
+static void ring_init(ring_t *r)
+{
+	register size_t i;
+
+	r->head = 0;
+	r->tail = 0;
+	r->done = false;
+	for (i = 0; i < RING_SIZE; i++)
+		r->slots[i].seq = i;
+}
+
+/*
+ *  Back off while the ring is full or empty, spin briefly, then
+ *  yield and finally sleep so idle threads don't hog the CPUs
+ */
+static void ring_backoff(uint32_t *spins)
+{
+	static const struct timespec ts = { 0, 50000 };
+
+	(*spins)++;
+	if (*spins < 16)
+		__asm__ __volatile__("" ::: "memory");
+	else if (*spins < 256)
+		(void)sched_yield();
+	else
+		(void)nanosleep(&ts, NULL);
+}
+
+/*
+ *  Push n files onto the ring, claiming as many free
+ *  consecutive slots as possible with each update of the tail
+ */
+static void ring_push(ring_t *RESTRICT r, const msg_t *RESTRICT msgs, size_t n)
+{
+	uint32_t spins = 0;
+
+	while (n) {
+		uint64_t pos = __atomic_load_n(&r->tail, __ATOMIC_RELAXED);
+		register size_t i, avail;
+
+		for (avail = 0; avail < n; avail++) {
+			const ring_slot_t *slot = &r->slots[(pos + avail) & RING_MASK];
+
+			if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != pos + avail)
+				break;
+		}
+		if (UNLIKELY(!avail)) {
+			ring_backoff(&spins);
+			continue;
+		}
+		if (UNLIKELY(!__atomic_compare_exchange_n(&r->tail, &pos, pos + avail,
+				false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)))
+			continue;
+
+		for (i = 0; i < avail; i++) {
+			ring_slot_t *slot = &r->slots[(pos + i) & RING_MASK];
+
+			slot->msg = msgs[i];
+			__atomic_store_n(&slot->seq, pos + i + 1, __ATOMIC_RELEASE);
+		}
+		msgs += avail;
+		n -= avail;
+		spins = 0;
+	}
+}
+
+/*
+ *  Pop up to max files off the ring, returns 0 if the
+ *  ring is currently empty
+ */
+static size_t ring_pop(ring_t *RESTRICT r, msg_t *RESTRICT msgs, const size_t max)
+{
+	for (;;) {
+		uint64_t pos = __atomic_load_n(&r->head, __ATOMIC_RELAXED);
+		register size_t i, n;
+
+		for (n = 0; n < max; n++) {
+			const ring_slot_t *slot = &r->slots[(pos + n) & RING_MASK];
+
+			if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != pos + n + 1)
+				break;
+		}
+		if (UNLIKELY(!n))
+			return 0;
+		if (UNLIKELY(!__atomic_compare_exchange_n(&r->head, &pos, pos + n,
+				false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)))
+			continue;
+
+		for (i = 0; i < n; i++) {
+			ring_slot_t *slot = &r->slots[(pos + i) & RING_MASK];
+
+			msgs[i] = slot->msg;
+			__atomic_store_n(&slot->seq, pos + i + RING_SIZE, __ATOMIC_RELEASE);
+		}
+		return n;
+	}
+}
+
+/*
+ *  Has the reader finished and the ring been drained? All
+ *  pushes happen before done is set, so emptiness is final
+ *  once done has been seen
+ */
+static bool ring_finished(ring_t *r)
+{
+	uint64_t pos;
+
+	if (!__atomic_load_n(&r->done, __ATOMIC_ACQUIRE))
+		return false;
+	pos = __atomic_load_n(&r->head, __ATOMIC_RELAXED);
+
+	return __atomic_load_n(&r->slots[pos & RING_MASK].seq, __ATOMIC_ACQUIRE) != pos + 1;
+}
+
+static void deque_init(deque_t *d)
+{
+	d->top = 0;
+	d->bottom = 0;
+}
+
+/*
+ *  Owner pushes n files, only ever done when the deque
+ *  is empty so it can never overflow
+ */
+static void deque_push(deque_t *RESTRICT d, const msg_t *RESTRICT msgs, const size_t n)
+{
+	const int64_t b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED);
+	register size_t i;
+
+	for (i = 0; i < n; i++)
+		d->msgs[(b + i) & DEQUE_MASK] = msgs[i];
+	__atomic_store_n(&d->bottom, b + n, __ATOMIC_RELEASE);
+}
+
+/*
+ *  Owner takes the most recently pushed file
+ */
+static bool deque_take(deque_t *RESTRICT d, msg_t *RESTRICT msg)
+{
+	const int64_t b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED) - 1;
+	int64_t t;
+
+	__atomic_store_n(&d->bottom, b, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	t = __atomic_load_n(&d->top, __ATOMIC_RELAXED);
+
+	if (t > b) {
+		__atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+		return false;
+	}
+	*msg = d->msgs[b & DEQUE_MASK];
+	if (t == b) {
+		/* Last one, race any thieves for it */
+		const bool won = __atomic_compare_exchange_n(&d->top, &t, t + 1,
+			false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+
+		__atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+		return won;
+	}
+	return true;
+}
+
+/*
+ *  Another worker steals the oldest file
  */
-static get_char_t HOT get_token(register parser_t *RESTRICT p, register token_t *RESTRICT t)
+static bool deque_steal(deque_t *RESTRICT d, msg_t *RESTRICT msg)
 {
-	for (;;) {
-		register get_char_t ret, ch = get_char(p);
-		register get_token_action_t action = get_token_actions[ch];
+	int64_t t = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE), b;
 
-		if (UNLIKELY(!action))
-			continue;
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	b = __atomic_load_n(&d->bottom, __ATOMIC_ACQUIRE);
+	if (t >= b)
+		return false;
 
-		ret = action(p, t, ch);
-		if (UNLIKELY(ret & PARSER_CONTINUE))
-			continue;
-		return ret;
-	}
+	*msg = d->msgs[t & DEQUE_MASK];
 
-	return PARSER_OK;
+	return __atomic_compare_exchange_n(&d->top, &t, t + 1,
+		false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+static inline bool is_source_file(const char *RESTRICT name, const size_t len)
+{
+	return ((len >= 2) && !__builtin_strcmp(name + len - 2, ".c")) ||
+	       ((len >= 2) && !__builtin_strcmp(name + len - 2, ".h")) ||
+	       ((len >= 4) && !__builtin_strcmp(name + len - 4, ".cpp"));
 }
 
 /*
- *  Literals such as "foo" and 'f' sometimes
- *  need the quotes stripping off.
+ *  Get a buffer from the pool, NULL if they are all in use
  */
-static inline void literal_strip_quotes(token_t *t)
+static void *pool_get(void)
 {
-	register size_t len = token_len(t);
+	void *buf = NULL;
+
+	(void)pthread_mutex_lock(&buffer_pool.lock);
+	if (buffer_pool.nfree) {
+		buf = buffer_pool.free[--buffer_pool.nfree];
+		(void)pthread_mutex_unlock(&buffer_pool.lock);
+		return buf;
+	}
+	if (buffer_pool.allocated == POOL_BUFFERS) {
+		(void)pthread_mutex_unlock(&buffer_pool.lock);
+		return NULL;
+	}
+	buffer_pool.allocated++;
+	(void)pthread_mutex_unlock(&buffer_pool.lock);
 
-	t->token[len - 1] = '\0';
+	if (posix_memalign(&buf, 64, POOL_BUFFER_SIZE))
+		out_of_memory();
+	return buf;
+}
 
-	__builtin_memmove(t->token, t->token + 1, len - 1);
+static void pool_put(void *buf)
+{
+	(void)pthread_mutex_lock(&buffer_pool.lock);
+	buffer_pool.free[buffer_pool.nfree++] = buf;
+	(void)pthread_mutex_unlock(&buffer_pool.lock);
+}
 
-	t->ptr -= 2;
+static void pool_free(void)
+{
+	while (buffer_pool.nfree)
+		free(buffer_pool.free[--buffer_pool.nfree]);
+	buffer_pool.allocated = 0;
 }
 
 /*
- *  Concatenate new string onto old. The old
- *  string can be NULL or an existing string
- *  on the heap.  This returns the newly
- *  concatenated string.
+ *  Get a buffer to read msg->size bytes of a file into
  */
-static void token_cat_normal(
-	token_t *RESTRICT token,
-	token_t *RESTRICT token_to_add)
+static void msg_alloc(msg_t *msg)
 {
-	token_cat_str(token, token_to_add->token);
+	if (LIKELY(msg->size <= POOL_BUFFER_SIZE)) {
+		msg->data = pool_get();
+		if (LIKELY(msg->data != NULL)) {
+			msg->type = MSG_POOL;
+			return;
+		}
+	}
+	msg->data = malloc(msg->size);
+	if (UNLIKELY(!msg->data))
+		out_of_memory();
+	msg->type = MSG_HEAP;
 }
 
 /*
- *  Concatenate new string onto old. The old
- *  string can be NULL or an existing string
- *  on the heap.  This returns the newly
- *  concatenated string.
+ *  Release a file's contents once it has been parsed
  */
-static void token_cat_just_literal_string(
-	token_t *RESTRICT token,
-	token_t *RESTRICT token_to_add)
+static void msg_release(msg_t *msg)
 {
-	if (token_to_add->type == TOKEN_LITERAL_STRING)
-		token_cat_str(token, token_to_add->token);
+	switch (msg->type) {
+	case MSG_MMAP:
+		(void)munmap(msg->data, msg->size);
+		break;
+	case MSG_POOL:
+		pool_put(msg->data);
+		break;
+	case MSG_HEAP:
+		free(msg->data);
+		break;
+	}
 }
 
-static void TARGET_CLONES strip_format(char *line)
+/*
+ *  Queue a file that has been loaded for the workers
+ */
+static void HOT queue_msg(context_t *RESTRICT ctxt, const msg_t *RESTRICT msg)
 {
-	register char *ptr1 = line, *ptr2 = line;
+	ctxt->bytes_total += msg->size;
 
-	while (*ptr1) {
-		if (UNLIKELY((*ptr1 == '%') && *(ptr1 + 1))) {
-			register size_t i;
+	/*
+	 *  Start big files as soon as they are found so no
+	 *  worker is left parsing one at the end of the run,
+	 *  pointless with just one worker
+	 */
+	if (UNLIKELY((jobs > 1) && (msg->size >= LARGE_FILE_SIZE))) {
+		ring_push(&ring_large, msg, 1);
+		return;
+	}
+	ctxt->batch[ctxt->batched] = *msg;
+	if (++ctxt->batched == RING_BATCH) {
+		ring_push(&ring, ctxt->batch, ctxt->batched);
+		ctxt->batched = 0;
+	}
+}
 
-			*ptr2++ = ' ';
-			ptr1++;
-			if (*ptr1 == '-')
-				ptr1++;
-			while (isdigit(*ptr1) || *ptr1 == '.')
-				ptr1++;
+static void walk_dir(context_t *RESTRICT ctxt, const int dirfd, const size_t pathlen);
+#if defined(HAVE_IO_URING)
+static void uring_complete(context_t *ctxt, const bool wait);
+#endif
+
+/*
+ *  Map an open source file and queue it for the workers
+ */
+static int msg_mmap(msg_t *RESTRICT msg, const int fd, const char *RESTRICT path)
+{
+	//(void)posix_fadvise(fd, 0, msg->size, POSIX_FADV_SEQUENTIAL);
+	msg->data = mmap(NULL, msg->size, PROT_READ,
+		MAP_PRIVATE | MAP_POPULATE, fd, 0);
+	if (UNLIKELY(msg->data == MAP_FAILED)) {
+		fprintf(stderr, "Cannot mmap %s, errno=%d (%s)\n",
+			path, errno, strerror(errno));
+		return -1;
+	}
+	msg->type = MSG_MMAP;
 
-			for (i = 0; i < SIZEOF_ARRAY(formats); i++) {
-				register const size_t len = formats[i].len;
+	return 0;
+}
 
-				if (UNLIKELY(!strncmp(formats[i].format, ptr1, len))) {
-					ptr1 += len;
-					break;
-				}
-			}
-		} else {
-			*ptr2++ = *ptr1++;
+/*
+ *  Read a small file into a (preferably pooled) buffer, this
+ *  avoids the cost of setting up and tearing down a mapping
+ */
+static int msg_read(msg_t *RESTRICT msg, const int fd, const char *RESTRICT path)
+{
+	size_t done = 0;
+
+	msg_alloc(msg);
+	while (done < msg->size) {
+		const ssize_t n = pread(fd, (uint8_t *)msg->data + done, msg->size - done, done);
+
+		if (UNLIKELY(n < 0)) {
+			if (errno == EINTR)
+				continue;
+			fprintf(stderr, "Cannot read %s, errno=%d (%s)\n",
+				path, errno, strerror(errno));
+			msg_release(msg);
+			return -1;
 		}
+		/* File may have shrunk under us */
+		if (UNLIKELY(n == 0))
+			break;
+		done += n;
 	}
-	*ptr2 = '\0';
+	msg->size = done;
+
+	return 0;
 }
 
 /*
- *  Parse a kernel message, like printk() or dev_err()
+ *  Load an open source file and queue it for the workers,
+ *  small files are read and larger ones mmap'd
  */
-static get_char_t HOT TARGET_CLONES parse_kernel_message(
+static int HOT queue_file(
+	context_t *RESTRICT ctxt,
+	const int fd,
 	const char *RESTRICT path,
-	bool *RESTRICT source_emit,
-	parser_t *RESTRICT p,
-	token_t *RESTRICT t,
-	token_t *RESTRICT line,
-	token_t *RESTRICT str)
+	const size_t len,
+	const off_t size)
 {
-	bool got_string = false;
-	bool emit = false;
-	bool found = false;
-	bool nl = false;
-	bool check_nl = ((opt_flags & OPT_MISSING_NEWLINE) != 0);
+	msg_t msg;
 
-	token_clear(line);
+	msg.size = size;
+	if (msg.size <= read_threshold) {
+		if (UNLIKELY(msg_read(&msg, fd, path) < 0))
+			return -1;
+		if (UNLIKELY(!msg.size)) {
+			msg_release(&msg);
+			return 0;
+		}
+	} else if (UNLIKELY(msg_mmap(&msg, fd, path) < 0)) {
+		return -1;
+	}
+	msg.filename = arena_strndup(&ctxt->arena, path, len);
+	queue_msg(ctxt, &msg);
 
-	token_cat(line, t);
-	token_clear(t);
-	if (UNLIKELY(get_token(p, t) == PARSER_EOF)) {
-		return PARSER_EOF;
+	return 0;
+}
+
+#if defined(HAVE_IO_URING)
+/*
+ *  io_uring file ingestion, each walker owns a ring and keeps up
+ *  to URING_DEPTH files in flight through openat, statx and read
+ *  into pooled buffers.  Only raw syscalls are used so there is
+ *  no dependency on liburing.
+ */
+static int uring_setup(const unsigned entries, struct io_uring_params *params)
+{
+	return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int uring_enter(const int fd, const unsigned to_submit, const unsigned min_complete)
+{
+	return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete,
+		min_complete ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+}
+
+/*
+ *  Check the kernel can do all the operations we need
+ */
+static bool uring_probe(const int fd)
+{
+	const size_t sz = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+	struct io_uring_probe *probe;
+	bool ok = false;
+
+	probe = calloc(1, sz);
+	if (!probe)
+		return false;
+	if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, 256) == 0) {
+		ok = (probe->last_op >= IORING_OP_READ) &&
+		     (probe->ops[IORING_OP_OPENAT].flags & IO_URING_OP_SUPPORTED) &&
+		     (probe->ops[IORING_OP_STATX].flags & IO_URING_OP_SUPPORTED) &&
+		     (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) &&
+		     (probe->ops[IORING_OP_CLOSE].flags & IO_URING_OP_SUPPORTED);
 	}
-	if (t->type != TOKEN_PAREN_OPENED) {
-		for (;;) {
-			if (UNLIKELY(get_token(p, t) == PARSER_EOF))
-				return PARSER_EOF;
-			if (t->type == TOKEN_TERMINAL)
-				break;
-		}
-		token_clear(t);
-		return PARSER_OK;
+	free(probe);
+
+	return ok;
+}
+
+static void uring_free(uring_t *u)
+{
+	if (!u)
+		return;
+	if (u->sqes)
+		(void)munmap(u->sqes, u->sqes_len);
+	if (u->cq_ptr && (u->cq_ptr != u->sq_ptr))
+		(void)munmap(u->cq_ptr, u->cq_len);
+	if (u->sq_ptr)
+		(void)munmap(u->sq_ptr, u->sq_len);
+	if (u->fd >= 0)
+		(void)close(u->fd);
+	free(u);
+}
+
+/*
+ *  Create a ring, returns NULL if io_uring is not available
+ */
+static uring_t *uring_new(void)
+{
+	struct io_uring_params params;
+	uring_t *u;
+	uint8_t *sq, *cq;
+	uint32_t i;
+
+	u = calloc(1, sizeof(*u));
+	if (!u)
+		out_of_memory();
+
+	(void)memset(&params, 0, sizeof(params));
+	u->fd = uring_setup(URING_ENTRIES, &params);
+	if (u->fd < 0)
+		goto err;
+	if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !uring_probe(u->fd))
+		goto err;
+
+	u->sq_len = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+	u->cq_len = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	if (u->cq_len > u->sq_len)
+		u->sq_len = u->cq_len;
+	u->cq_len = u->sq_len;
+	u->sq_ptr = mmap(NULL, u->sq_len, PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_POPULATE, u->fd, IORING_OFF_SQ_RING);
+	if (u->sq_ptr == MAP_FAILED) {
+		u->sq_ptr = NULL;
+		goto err;
+	}
+	u->cq_ptr = u->sq_ptr;
+	u->sqes_len = params.sq_entries * sizeof(struct io_uring_sqe);
+	u->sqes = mmap(NULL, u->sqes_len, PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_POPULATE, u->fd, IORING_OFF_SQES);
+	if (u->sqes == MAP_FAILED) {
+		u->sqes = NULL;
+		goto err;
 	}
-	token_cat(line, t);
-	token_clear(t);
 
-	token_clear(str);
-	for (;;) {
-		get_char_t ret = get_token(p, t);
+	sq = u->sq_ptr;
+	cq = u->cq_ptr;
+	u->sq_tail = (uint32_t *)(sq + params.sq_off.tail);
+	u->sq_head = (uint32_t *)(sq + params.sq_off.head);
+	u->sq_mask = *(uint32_t *)(sq + params.sq_off.ring_mask);
+	u->sq_entries = params.sq_entries;
+	u->sq_array = (uint32_t *)(sq + params.sq_off.array);
+	u->cq_head = (uint32_t *)(cq + params.cq_off.head);
+	u->cq_tail = (uint32_t *)(cq + params.cq_off.tail);
+	u->cq_mask = *(uint32_t *)(cq + params.cq_off.ring_mask);
+	u->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+	for (i = 0; i < URING_DEPTH; i++)
+		u->free_reqs[i] = URING_DEPTH - i - 1;
+	u->nfree = URING_DEPTH;
+
+	return u;
+err:
+	uring_free(u);
+	return NULL;
+}
 
-		if (UNLIKELY(ret == PARSER_EOF))
-			return PARSER_EOF;
+/*
+ *  Hand the queued submission queue entries to the kernel
+ */
+static void uring_submit(uring_t *u, const unsigned min_complete)
+{
+	int ret;
 
-		/*
-		 *  Hit ; so lets push out what we've parsed
-		 */
-		if (t->type == TOKEN_TERMINAL) {
-			if (check_nl & nl) {
-				emit = false;
-			}
-			if (emit) {
-				if (opt_flags & OPT_CHECK_WORDS)
-					check_words(line);
-				else {
-					char *ptr;
-					if (! *source_emit) {
-						if (opt_flags & OPT_SOURCE_NAME)
-							printf("Source: %s\n", path);
-						*source_emit = true;
-					}
-					if (opt_flags & OPT_FORMAT_STRIP)
-						strip_format(line->token);
+	if (u->to_submit)
+		__atomic_store_n(u->sq_tail, u->sqe_tail, __ATOMIC_RELEASE);
+	if (!u->to_submit && !min_complete)
+		return;
 
-					for (ptr = line->token; isblank(*ptr); ptr++)
-						;
+	ret = uring_enter(u->fd, u->to_submit, min_complete);
+	if (ret >= 0) {
+		u->to_submit -= ret;
+	} else if ((errno != EINTR) && (errno != EAGAIN) && (errno != EBUSY)) {
+		fprintf(stderr, "io_uring_enter failed, errno=%d (%s)\n",
+			errno, strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+}
 
-					printf(" %s%s\n", ptr, (opt_flags & OPT_LITERAL_STRINGS) ? "" : ";");
-				}
-				finds++;
-			}
-			token_clear(t);
-			return PARSER_OK;
-		}
+/*
+ *  Get a submission queue entry, submitting what is queued
+ *  if the submission queue is full
+ */
+static struct io_uring_sqe *uring_sqe(uring_t *u, const uint64_t user_data)
+{
+	uint32_t tail, index;
+	struct io_uring_sqe *sqe;
 
-		if (t->type == TOKEN_LITERAL_STRING) {
-			literal_strip_quotes(t);
-			token_cat(str, t);
+	while (UNLIKELY(u->sqe_tail - __atomic_load_n(u->sq_head, __ATOMIC_ACQUIRE) >= u->sq_entries))
+		uring_submit(u, 0);
 
-			if (!got_string)
-				token_cat_str(line, quotes);
+	tail = u->sqe_tail++;
+	index = tail & u->sq_mask;
+	sqe = &u->sqes[index];
 
-			got_string = true;
-			emit = true;
-		} else {
-			if (got_string) {
-				register size_t len = token_len(line);
+	(void)memset(sqe, 0, sizeof(*sqe));
+	sqe->user_data = user_data;
+	u->sq_array[index] = index;
+	u->to_submit++;
+	u->in_flight++;
 
-				if ((check_nl) &&
-				    (len > 2) &&
-				    (line->token[len - 3] == '\\') &&
-				    (line->token[len - 2] == 'n')) {
-					nl = true;
-				}
-				token_cat_str(line, quotes);
-			}
-			got_string = false;
+	return sqe;
+}
 
-			if (token_len(str)) {
-				found |= true;
-				token_clear(str);
+static void uring_req_free(uring_t *u, uring_req_t *req)
+{
+	u->free_reqs[u->nfree++] = req - u->reqs;
+}
+
+static void uring_close(uring_t *u, const int fd)
+{
+	struct io_uring_sqe *sqe = uring_sqe(u, URING_CLOSE);
+
+	sqe->opcode = IORING_OP_CLOSE;
+	sqe->fd = fd;
+}
+
+static void uring_read(uring_t *u, uring_req_t *req)
+{
+	struct io_uring_sqe *sqe = uring_sqe(u, req - u->reqs);
+
+	sqe->opcode = IORING_OP_READ;
+	sqe->fd = req->fd;
+	sqe->addr = (uint64_t)(uintptr_t)((uint8_t *)req->msg.data + req->done);
+	sqe->len = req->msg.size - req->done;
+	sqe->off = req->done;
+}
+
+/*
+ *  Queue a source file to be opened, stat'd and read
+ */
+static void uring_queue_file(
+	context_t *RESTRICT ctxt,
+	const char *RESTRICT path,
+	const size_t len)
+{
+	uring_t *u = ctxt->uring;
+	uring_req_t *req;
+	struct io_uring_sqe *sqe;
+
+	while (!u->nfree)
+		uring_complete(ctxt, true);
+
+	req = &u->reqs[u->free_reqs[--u->nfree]];
+	req->state = URING_OPEN;
+	req->fd = -1;
+	req->done = 0;
+	req->msg.filename = arena_strndup(&ctxt->arena, path, len);
+
+	sqe = uring_sqe(u, req - u->reqs);
+	sqe->opcode = IORING_OP_OPENAT;
+	sqe->fd = AT_FDCWD;
+	sqe->addr = (uint64_t)(uintptr_t)req->msg.filename;
+	sqe->rw_flags = O_RDONLY | O_NOATIME;
+}
+
+/*
+ *  Move a request on to its next operation
+ */
+static void uring_advance(context_t *RESTRICT ctxt, uring_req_t *RESTRICT req, const int32_t res)
+{
+	uring_t *u = ctxt->uring;
+	struct io_uring_sqe *sqe;
+
+	switch (req->state) {
+	case URING_OPEN:
+		if (UNLIKELY(res < 0)) {
+			fprintf(stderr, "Cannot open %s, errno=%d (%s)\n",
+				req->msg.filename, -res, strerror(-res));
+			break;
+		}
+		req->fd = res;
+		req->state = URING_STATX;
+		sqe = uring_sqe(u, req - u->reqs);
+		sqe->opcode = IORING_OP_STATX;
+		sqe->fd = req->fd;
+		sqe->addr = (uint64_t)(uintptr_t)"";
+		sqe->len = STATX_SIZE;
+		sqe->off = (uint64_t)(uintptr_t)&req->stx;
+		sqe->rw_flags = AT_EMPTY_PATH;
+		return;
+	case URING_STATX:
+		if (UNLIKELY(res < 0)) {
+			fprintf(stderr, "Cannot stat %s, errno=%d (%s)\n",
+				req->msg.filename, -res, strerror(-res));
+			break;
+		}
+		ctxt->files++;
+		if (UNLIKELY(req->stx.stx_size == 0))
+			break;
+		req->msg.size = req->stx.stx_size;
+		if (UNLIKELY(req->msg.size > read_threshold)) {
+			/* Large files are better off mmap'd */
+			if (LIKELY(msg_mmap(&req->msg, req->fd, req->msg.filename) == 0)) {
+				queue_msg(ctxt, &req->msg);
+				uring_close(u, req->fd);
+				uring_req_free(u, req);
+				return;
 			}
+			break;
 		}
+		msg_alloc(&req->msg);
+		req->state = URING_READ;
+		uring_read(u, req);
+		return;
+	case URING_READ:
+		if (UNLIKELY(res < 0)) {
+			fprintf(stderr, "Cannot read %s, errno=%d (%s)\n",
+				req->msg.filename, -res, strerror(-res));
+			msg_release(&req->msg);
+			break;
+		}
+		req->done += res;
+		if ((res > 0) && (req->done < req->msg.size)) {
+			/* Short read, get the rest */
+			uring_read(u, req);
+			return;
+		}
+		/* File may have shrunk under us */
+		req->msg.size = req->done;
+		uring_close(u, req->fd);
+		if (LIKELY(req->msg.size)) {
+			queue_msg(ctxt, &req->msg);
+		} else {
+			msg_release(&req->msg);
+		}
+		uring_req_free(u, req);
+		return;
+	}
 
-		token_cat(line, t);
-		if (t->type == TOKEN_COMMA)
-			token_cat_str(line, space);
+	/* Failed, clean up */
+	if (req->fd >= 0)
+		uring_close(u, req->fd);
+	uring_req_free(u, req);
+}
 
-		token_clear(t);
+/*
+ *  Submit pending operations and handle the completions,
+ *  optionally waiting for at least one to complete
+ */
+static void uring_complete(context_t *ctxt, const bool wait)
+{
+	uring_t *u = ctxt->uring;
+	uint32_t head, tail;
+
+	uring_submit(u, (wait && u->in_flight) ? 1 : 0);
+
+	head = *u->cq_head;
+	tail = __atomic_load_n(u->cq_tail, __ATOMIC_ACQUIRE);
+	while (head != tail) {
+		const struct io_uring_cqe *cqe = &u->cqes[head & u->cq_mask];
+		const uint64_t user_data = cqe->user_data;
+		const int32_t res = cqe->res;
+
+		head++;
+		__atomic_store_n(u->cq_head, head, __ATOMIC_RELEASE);
+		u->in_flight--;
+		if (user_data != URING_CLOSE)
+			uring_advance(ctxt, &u->reqs[user_data], res);
+		tail = __atomic_load_n(u->cq_tail, __ATOMIC_ACQUIRE);
 	}
 }
 
 /*
- *  Parse input looking for printk like function calls
+ *  Wait for all the files in flight to be queued
  */
-static void parse_kernel_messages(
+static void uring_drain(context_t *ctxt)
+{
+	while (ctxt->uring->in_flight || ctxt->uring->to_submit)
+		uring_complete(ctxt, true);
+}
+#endif
+
+
+/*
+ *  Hand a sub-directory to an idle walker, returns false
+ *  if nobody is idle and the caller should walk it itself
+ */
+static bool walk_handoff(
+	context_t *RESTRICT ctxt,
+	const int dirfd,
 	const char *RESTRICT path,
-	unsigned char *RESTRICT data,
-	unsigned char *RESTRICT data_end,
-	token_t *RESTRICT t,
-	token_t *RESTRICT line,
-	token_t *RESTRICT str)
+	const size_t pathlen)
 {
-	parser_t p;
+	walk_dir_t *dir;
 
-	parser_new(&p, data, data_end, true);
-	bool source_emit = false;
+	if (LIKELY(__atomic_load_n(&walk_pool.idle, __ATOMIC_RELAXED) <=
+		   __atomic_load_n(&walk_pool.queued, __ATOMIC_RELAXED)))
+		return false;
 
-	token_clear(t);
+	(void)pthread_mutex_lock(&walk_pool.lock);
+	if (walk_pool.idle <= walk_pool.queued) {
+		(void)pthread_mutex_unlock(&walk_pool.lock);
+		return false;
+	}
+	dir = &walk_pool.dirs[walk_pool.queued++];
+	dir->fd = dirfd;
+	dir->pathlen = pathlen;
+	dir->path = arena_strndup(&ctxt->arena, path, pathlen);
+	(void)pthread_cond_signal(&walk_pool.cond);
+	(void)pthread_mutex_unlock(&walk_pool.lock);
+
+	return true;
+}
 
-	while ((get_token(&p, t)) != PARSER_EOF) {
-		if ((t->type == TOKEN_IDENTIFIER) &&
-		    (find_word(t->token, printk_nodes, printk_node_heap))) {
-			parse_kernel_message(path, &source_emit, &p, t, line, str);
-			//source_emit = true;
-		}
-		token_clear(t);
+/*
+ *  getdents64 buffer for the directory being walked. Sub-directories
+ *  are walked recursively, so the buffers are kept per depth off the
+ *  stack, which would overflow on deep trees, and reused for the
+ *  next directory at the same depth
+ */
+static char *walk_dirents(context_t *ctxt)
+{
+	if (UNLIKELY(ctxt->depth >= ctxt->max_depth)) {
+		const uint32_t max_depth = ctxt->max_depth ? ctxt->max_depth * 2 : 16;
+		char **dirents;
+		uint32_t i;
+
+		dirents = realloc(ctxt->dirents, max_depth * sizeof(*dirents));
+		if (UNLIKELY(!dirents))
+			out_of_memory();
+		for (i = ctxt->max_depth; i < max_depth; i++)
+			dirents[i] = NULL;
+		ctxt->dirents = dirents;
+		ctxt->max_depth = max_depth;
 	}
+	if (UNLIKELY(!ctxt->dirents[ctxt->depth])) {
+		ctxt->dirents[ctxt->depth] = malloc(DIRENTS_SIZE);
+		if (UNLIKELY(!ctxt->dirents[ctxt->depth]))
+			out_of_memory();
+	}
+	return ctxt->dirents[ctxt->depth];
+}
 
-	if (opt_flags & OPT_CHECK_WORDS)
-		return;
-	if (source_emit && (opt_flags & OPT_SOURCE_NAME))
-		putchar('\n');
+static void walk_dirents_free(context_t *ctxt)
+{
+	uint32_t i;
+
+	for (i = 0; i < ctxt->max_depth; i++)
+		free(ctxt->dirents[i]);
+	free(ctxt->dirents);
 }
 
 /*
- *  Parse input looking for literal strings
+ *  Walk a directory with getdents64(), ctxt->filepath holds the
+ *  directory's path. d_type saves a stat per entry, fstatat() is
+ *  only needed when the file system does not fill it in, and
+ *  entries are opened relative to the directory fd
  */
-static void parse_literal_strings(
-	const char *RESTRICT path,
-	unsigned char *RESTRICT data,
-	unsigned char *RESTRICT data_end,
-	token_t *RESTRICT t,
-	token_t *RESTRICT line,
-	token_t *RESTRICT str)
+static void walk_dir(context_t *RESTRICT ctxt, const int dirfd, const size_t pathlen)
 {
-	parser_t p;
+	char *const buffer = walk_dirents(ctxt);
+	char *const filepath = ctxt->filepath;
 
-	(void)path;
-	(void)line;
-	(void)str;
+	filepath[pathlen] = '/';
 
-	parser_new(&p, data, data_end, true);
+	for (;;) {
+		register long n, off;
+
+		n = syscall(SYS_getdents64, dirfd, buffer, DIRENTS_SIZE);
+		if (n <= 0) {
+			if (UNLIKELY(n < 0)) {
+				filepath[pathlen] = '\0';
+				fprintf(stderr, "Cannot read directory %s, errno=%d (%s)\n",
+					filepath, errno, strerror(errno));
+			}
+			break;
+		}
 
-	token_clear(t);
+		for (off = 0; off < n; ) {
+			const linux_dirent64_t *d = (const linux_dirent64_t *)(buffer + off);
+			const char *name = d->d_name;
+			unsigned char type = d->d_type;
+			size_t namelen, len;
+			int fd;
 
-	while ((get_token(&p, t)) != PARSER_EOF) {
-		if (t->type == TOKEN_LITERAL_STRING)
-			check_words(t);
-		token_clear(t);
+			off += d->d_reclen;
+			if (UNLIKELY(name[0] == '.'))
+				continue;
+
+			if (UNLIKELY(type == DT_UNKNOWN)) {
+				struct stat buf;
+
+				if (fstatat(dirfd, name, &buf, AT_SYMLINK_NOFOLLOW) < 0)
+					continue;
+				if (S_ISDIR(buf.st_mode))
+					type = DT_DIR;
+				else if (S_ISREG(buf.st_mode))
+					type = DT_REG;
+				else
+					continue;
+			}
+
+			namelen = __builtin_strlen(name);
+			len = pathlen + 1 + namelen;
+			if (UNLIKELY(len >= PATH_MAX))
+				continue;
+
+			if (type == DT_DIR) {
+				fd = openat(dirfd, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW);
+				__builtin_memcpy(filepath + pathlen + 1, name, namelen + 1);
+				if (UNLIKELY(fd < 0)) {
+					fprintf(stderr, "Cannot open directory %s, errno=%d (%s)\n",
+						filepath, errno, strerror(errno));
+					continue;
+				}
+				if (!walk_handoff(ctxt, fd, filepath, len)) {
+					ctxt->depth++;
+					walk_dir(ctxt, fd, len);
+					ctxt->depth--;
+					filepath[pathlen] = '/';
+				}
+			} else if (type == DT_REG) {
+				struct stat buf;
+
+				/* Symlinks, devices, fifos etc are skipped */
+				if (!is_source_file(name, namelen))
+					continue;
+
+				__builtin_memcpy(filepath + pathlen + 1, name, namelen + 1);
+#if defined(HAVE_IO_URING)
+				if (ctxt->uring) {
+					uring_queue_file(ctxt, filepath, len);
+					continue;
+				}
+#endif
+				fd = openat(dirfd, name, O_RDONLY | O_NOATIME);
+				if (UNLIKELY(fd < 0)) {
+					fprintf(stderr, "Cannot open %s, errno=%d (%s)\n",
+						filepath, errno, strerror(errno));
+					continue;
+				}
+				if (UNLIKELY(fstat(fd, &buf) < 0)) {
+					fprintf(stderr, "Cannot stat %s, errno=%d (%s)\n",
+						filepath, errno, strerror(errno));
+					(void)close(fd);
+					continue;
+				}
+				if (LIKELY(buf.st_size > 0) &&
+				    UNLIKELY(queue_file(ctxt, fd, filepath, len, buf.st_size) < 0)) {
+					(void)close(fd);
+					continue;
+				}
+				ctxt->files++;
+				(void)close(fd);
+			}
+		}
+#if defined(HAVE_IO_URING)
+		if (ctxt->uring)
+			uring_complete(ctxt, false);
+#endif
 	}
+	filepath[pathlen] = '\0';
+	(void)close(dirfd);
 }
 
-static void show_usage(void)
+/*
+ *  Walk directories handed over by the other walkers until
+ *  the queue is empty and no walker is busy
+ */
+static void *walker(void *arg)
 {
-	fprintf(stderr, "kernelscan: the fast kernel source message scanner\n\n");
-	fprintf(stderr, "kernelscan [options] path\n");
-	fprintf(stderr, "  -c       check words in dictionary\n");
-	fprintf(stderr, "  -d file  specify dictionary file\n");
-	fprintf(stderr, "  -e       strip out C escape sequences\n");
-	fprintf(stderr, "  -f       replace kernel %% format specifiers with a space\n");
-	fprintf(stderr, "  -h       show this help\n");
-	fprintf(stderr, "  -k       same as -ceflsx\n");
-	fprintf(stderr, "  -l       scan all literal strings and not print statements\n");
-	fprintf(stderr, "  -n       find messages with missing \\n newline\n");
-	fprintf(stderr, "  -s       just print literal strings\n");
-	fprintf(stderr, "  -x       exclude the source file name from the output\n");
-}
+	static void *nowt = NULL;
+	context_t *ctxt = arg;
 
-static int parse_dir(char *RESTRICT path, const mqd_t mq)
-{
-	DIR *dp;
-	struct dirent *d;
-	char filepath[PATH_MAX];
-	register char *ptr1, *ptr2;
+	(void)pthread_mutex_lock(&walk_pool.lock);
+	for (;;) {
+		walk_dir_t dir;
 
-	if (UNLIKELY((dp = opendir(path)) == NULL)) {
-		fprintf(stderr, "Cannot open directory %s, errno=%d (%s)\n",
-			path, errno, strerror(errno));
-		return -1;
-	}
+		while (!walk_pool.queued && walk_pool.busy) {
+			walk_pool.idle++;
+			(void)pthread_cond_wait(&walk_pool.cond, &walk_pool.lock);
+			walk_pool.idle--;
+		}
+		if (!walk_pool.queued)
+			break;
 
-	ptr1 = filepath;
-	ptr2 = path;
+		dir = walk_pool.dirs[--walk_pool.queued];
+		walk_pool.busy++;
+		(void)pthread_mutex_unlock(&walk_pool.lock);
 
-	while ((*ptr1 = *(ptr2++)))
-		ptr1++;
+		__builtin_memcpy(ctxt->filepath, dir.path, dir.pathlen + 1);
+		walk_dir(ctxt, dir.fd, dir.pathlen);
 
-	*ptr1++ = '/';
+		(void)pthread_mutex_lock(&walk_pool.lock);
+		walk_pool.busy--;
+	}
+	(void)pthread_cond_broadcast(&walk_pool.cond);
+	(void)pthread_mutex_unlock(&walk_pool.lock);
 
-	while ((d = readdir(dp)) != NULL) {
-		struct stat buf;
-		register char *ptr;
+#if defined(HAVE_IO_URING)
+	if (ctxt->uring)
+		uring_drain(ctxt);
+#endif
+	ring_push(&ring, ctxt->batch, ctxt->batched);
+	ctxt->batched = 0;
 
-		if (LIKELY(d->d_name[0] != '.')) {
-			ptr = ptr1;
-			ptr2 = d->d_name;
-			while ((*ptr = *(ptr2++)))
-				ptr++;
-			*ptr = '\0';
-			if (lstat(filepath, &buf) < 0)
-				continue;
-			/* Don't follow symlinks */
-			if (S_ISLNK(buf.st_mode))
-				continue;
-			parse_file(filepath, mq);
-		}
-	}
-	(void)closedir(dp);
+	return &nowt;
+}
 
-	return 0;
+/*
+ *  Walk a directory tree with a pool of walker threads,
+ *  the calling thread being the first of them
+ */
+static void walk_tree(const int dirfd, const char *path)
+{
+	size_t len = __builtin_strlen(path);
+	uint32_t i, started;
+
+	if (UNLIKELY(len >= PATH_MAX)) {
+		(void)close(dirfd);
+		return;
+	}
+	walk_pool.dirs[0].fd = dirfd;
+	walk_pool.dirs[0].pathlen = len;
+	walk_pool.dirs[0].path = arena_strndup(&walk_contexts[0].arena, path, len);
+	walk_pool.queued = 1;
+	walk_pool.idle = 0;
+	walk_pool.busy = 0;
+
+	for (started = 1; started < walkers; started++) {
+		if (pthread_create(&walk_contexts[started].pthread, NULL, walker, &walk_contexts[started]))
+			break;
+	}
+	(void)walker(&walk_contexts[0]);
+	for (i = 1; i < started; i++)
+		(void)pthread_join(walk_contexts[i].pthread, NULL);
 }
 
-static int HOT parse_file(
-	char *RESTRICT path,
-	const mqd_t mq)
+static int HOT parse_file(char *RESTRICT path)
 {
+	context_t *ctxt = &walk_contexts[0];
 	struct stat buf;
 	int fd;
-	int rc = 0;
-
-	const parse_func_t parse_func = (opt_flags & OPT_PARSE_STRINGS) ?
-		parse_literal_strings : parse_kernel_messages;
 
 	fd = open(path, O_RDONLY | O_NOATIME);
 	if (UNLIKELY(fd < 0)) {
@@ -3927,112 +5596,255 @@ static int HOT parse_file(
 		(void)close(fd);
 		return -1;
 	}
-	lineno = 0;
 
 	if (LIKELY(S_ISREG(buf.st_mode))) {
 		register size_t len = __builtin_strlen(path);
 
-		if (LIKELY(((len >= 2) && !__builtin_strcmp(path + len - 2, ".c")) ||
-		    ((len >= 2) && !__builtin_strcmp(path + len - 2, ".h")) ||
-		    ((len >= 4) && !__builtin_strcmp(path + len - 4, ".cpp")))) {
-			if (LIKELY(buf.st_size > 0)) {
-				msg_t msg;
-
-				//(void)posix_fadvise(fd, 0, buf.st_size, POSIX_FADV_SEQUENTIAL);
-				msg.data = mmap(NULL, (size_t)buf.st_size, PROT_READ,
-					MAP_PRIVATE | MAP_POPULATE, fd, 0);
-				if (UNLIKELY(msg.data == MAP_FAILED)) {
-					(void)close(fd);
-					fprintf(stderr, "Cannot mmap %s, errno=%d (%s)\n",
-						path, errno, strerror(errno));
-					return -1;
-				}
-				bytes_total += buf.st_size;
-
-				msg.parse_func = parse_func;
-				msg.size = buf.st_size;
-				strncpy(msg.filename, path, sizeof(msg.filename) - 1);
-				mq_send(mq, (char *)&msg, sizeof(msg), 1);
+		if (LIKELY(is_source_file(path, len))) {
+			if (LIKELY(buf.st_size > 0) &&
+			    UNLIKELY(queue_file(ctxt, fd, path, len, buf.st_size) < 0)) {
+				(void)close(fd);
+				return -1;
 			}
-			files++;
+			ctxt->files++;
 		}
 		(void)close(fd);
+		ring_push(&ring, ctxt->batch, ctxt->batched);
+		ctxt->batched = 0;
+	} else if (S_ISDIR(buf.st_mode)) {
+		walk_tree(fd, path);
 	} else {
 		(void)close(fd);
-		if (S_ISDIR(buf.st_mode))
-			rc = parse_dir(path, mq);
 	}
-	return rc;
+	return 0;
 }
 
-
 static void *reader(void *arg)
 {
 	static void *nowt = NULL;
-	const context_t *ctxt = arg;
-	msg_t msg = { NULL, 0, NULL, "" };
-
-	parse_file(ctxt->path, ctxt->mq);
-	mq_send(ctxt->mq, (char *)&msg, sizeof(msg), 1);
+	register uint32_t i;
+
+	parse_file((char *)arg);
+	for (i = 0; i < walkers; i++) {
+		files += walk_contexts[i].files;
+		bytes_total += walk_contexts[i].bytes_total;
+		walk_contexts[i].files = 0;
+		walk_contexts[i].bytes_total = 0;
+	}
+	__atomic_store_n(&ring_large.done, true, __ATOMIC_RELEASE);
+	__atomic_store_n(&ring.done, true, __ATOMIC_RELEASE);
 
 	return &nowt;
 }
 
-static int parse_path(
-	char *path,
-	token_t *RESTRICT t,
-	token_t *RESTRICT line,
-	token_t *RESTRICT str)
-{
-	mqd_t mq = -1;
-	struct mq_attr attr;
-	char mq_name[64];
-	int rc;
-	context_t ctxt;
-	pthread_t pthread;
+/*
+ *  Write out the worker's output for the file it has just
+ *  parsed in one go so output from workers does not interleave
+ */
+static void worker_flush(worker_t *w)
+{
+	register const size_t len = token_len(&w->out);
 
-	(void)snprintf(mq_name, sizeof(mq_name), "/kernelscan-%i", getpid());
+	if (!len)
+		return;
+
+	(void)pthread_mutex_lock(&output_lock);
+	(void)fwrite(w->out.token, 1, len, stdout);
+	(void)pthread_mutex_unlock(&output_lock);
+	token_clear(&w->out);
+}
 
-	attr.mq_flags = 0;
-	attr.mq_maxmsg = 10;
-	attr.mq_msgsize = sizeof(msg_t);
-	attr.mq_curmsgs = 0;
+static int cmp_msg_size(const void *p1, const void *p2)
+{
+	const msg_t *m1 = (const msg_t *)p1;
+	const msg_t *m2 = (const msg_t *)p2;
 
-	mq = mq_open(mq_name, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR, &attr);
-	if (mq < 0)
+	if (m1->size < m2->size)
 		return -1;
+	if (m1->size > m2->size)
+		return 1;
+	return 0;
+}
+
+/*
+ *  Refill an empty deque from the rings, large files first.
+ *  The batch is sorted by ascending size so the owner takes
+ *  the largest first and thieves get the smaller ones.
+ */
+static bool worker_refill(worker_t *w)
+{
+	msg_t msgs[RING_BATCH];
+	size_t n;
+
+	n = ring_pop(&ring_large, msgs, 1);
+	if (!n) {
+		n = ring_pop(&ring, msgs, RING_BATCH);
+		if (!n)
+			return false;
+	}
+	if (jobs > 1)
+		qsort(msgs, n, sizeof(msg_t), cmp_msg_size);
+	else {
+		/* Keep readdir order, the deque hands back the newest first */
+		register size_t i;
 
-	ctxt.path = path;
-	ctxt.mq = mq;
+		for (i = 0; i < n / 2; i++) {
+			const msg_t tmp = msgs[i];
 
-	rc = pthread_create(&pthread, NULL, reader, &ctxt);
-	if (rc) {
-		rc = -1;
-		goto err;
+			msgs[i] = msgs[n - i - 1];
+			msgs[n - i - 1] = tmp;
+		}
+	}
+	deque_push(&w->deque, msgs, n);
+
+	return true;
+}
+
+/*
+ *  Try and steal a file from the other workers
+ */
+static bool worker_steal(worker_t *RESTRICT w, msg_t *RESTRICT msg)
+{
+	register uint32_t i;
+
+	for (i = 1; i < jobs; i++) {
+		worker_t *victim = &workers[(w->id + i) % jobs];
+
+		if (deque_steal(&victim->deque, msg))
+			return true;
 	}
+	return false;
+}
+
+/*
+ *  Parse files from the work-stealing deques until the
+ *  reader has finished and there is nothing left to do
+ */
+static void *worker(void *arg)
+{
+	static void *nowt = NULL;
+	worker_t *w = arg;
+	uint32_t spins = 0;
 
 	for (;;) {
 		msg_t msg;
 
-		rc = mq_receive(mq, (char *)&msg, sizeof(msg), NULL);
-		if (UNLIKELY(rc < 0))
-			break;
-		if (UNLIKELY(msg.data == 0))
-			break;
+		if (!deque_take(&w->deque, &msg)) {
+			if (worker_refill(w))
+				continue;
+			if (!worker_steal(w, &msg)) {
+				if (ring_finished(&ring_large) && ring_finished(&ring))
+					break;
+				ring_backoff(&spins);
+				continue;
+			}
+		}
+		spins = 0;
 
 		__builtin_prefetch(msg.data, 0, 3);
 		__builtin_prefetch((uint8_t *)msg.data + 64, 0, 3);
-		msg.parse_func(msg.filename, msg.data, (uint8_t *)msg.data + msg.size, t, line, str);
-		(void)munmap(msg.data, msg.size);
+		parse_func(w, msg.filename, msg.data, (uint8_t *)msg.data + msg.size);
+		msg_release(&msg);
+		worker_flush(w);
 	}
 
-	rc = 0;
-err:
+	/* second phase, check each unique word just the once */
+	if (w->words.used) {
+		check_unique_words(w);
+		word_set_clear(&w->words);
+	}
+
+	return &nowt;
+}
+
+static void worker_new(worker_t *w, spelling_table_t *table)
+{
+	token_new(&w->t);
+	token_new(&w->line);
+	token_new(&w->str);
+	token_new(&w->format);
+	token_new(&w->out);
+	w->spellings = table;
+}
+
+static void worker_free(worker_t *w)
+{
+	word_set_free(&w->words);
+	arena_free(&w->arena);
+	free(w->dmesg.formats);
+	free(w->newlines.offsets);
+	token_free(&w->out);
+	token_free(&w->format);
+	token_free(&w->str);
+	token_free(&w->line);
+	token_free(&w->t);
+}
+
+/*
+ *  Fold a worker's statistics and bad spellings into the
+ *  global totals, worker 0 owns the global spelling table so
+ *  just the other workers' entries need moving across. The
+ *  words stay in the worker's arena, which lasts until exit
+ */
+static void worker_merge(worker_t *w)
+{
+	spelling_table_t *t = w->spellings;
+	register uint32_t i;
+
+	finds += w->finds;
+	lines += w->lines;
+	bad_spellings_total += w->bad_spellings_total;
+	format_mismatches += w->format_mismatches;
+
+	if (t == &spellings) {
+		bad_spellings += w->bad_spellings;
+		return;
+	}
+
+	/*
+	 *  Words come out in slot order, which follows their hashes,
+	 *  so growing part way through would pack them into a few
+	 *  long runs
+	 */
+	spelling_table_reserve(&spellings, spellings.used + t->used);
+	for (i = 0; i < t->size; i++) {
+		const spelling_t *slot = &t->slots[i];
+
+		if ((t->ctrl[i] != SPELLING_EMPTY) &&
+		    spelling_table_add(&spellings, slot->word, slot->len, slot->hash))
+			bad_spellings++;
+	}
+
+	spelling_table_free(t);
+	free(t);
+	w->spellings = NULL;
+}
+
+static int parse_path(char *path)
+{
+	uint32_t i, started;
+	pthread_t pthread;
+
+	ring_init(&ring);
+	ring_init(&ring_large);
+
+	if (pthread_create(&pthread, NULL, reader, path))
+		return -1;
+
+	/* Worker 0 runs on this thread, the others get their own */
+	for (i = 0; i < jobs; i++)
+		deque_init(&workers[i].deque);
+	for (started = 1; started < jobs; started++) {
+		if (pthread_create(&workers[started].pthread, NULL, worker, &workers[started]))
+			break;
+	}
+	(void)worker(&workers[0]);
+	for (i = 1; i < started; i++)
+		(void)pthread_join(workers[i].pthread, NULL);
+
 	(void)pthread_join(pthread, NULL);
-	(void)mq_close(mq);
-	(void)mq_unlink(mq_name);
 
-	return rc;
+	return 0;
 }
 
 static int cmpstr(const void *p1, const void *p2)
@@ -4042,71 +5854,74 @@ static int cmpstr(const void *p1, const void *p2)
 
 static void dump_bad_spellings(void)
 {
-	register size_t i, j;
-	register char **bad_spellings_sorted;
-	const size_t sz = bad_spellings * sizeof(char *);
+	register uint32_t i, j;
+	const char **bad_spellings_sorted;
 
-	bad_spellings_sorted = malloc(sz);
+	bad_spellings_sorted = malloc((spellings.used + 1) * sizeof(*bad_spellings_sorted));
 	if (!bad_spellings_sorted)
 		out_of_memory();
 
-	for (i = 0, j = 0; i < SIZEOF_ARRAY(hash_bad_spellings); i++) {
-		register hash_entry_t *he = hash_bad_spellings[i];
-
-		while (he) {
-			hash_entry_t *next = he->next;
-			bad_spellings_sorted[j++] = he->token;
-			he = next;
-		}
+	for (i = 0, j = 0; i < spellings.size; i++) {
+		if (spellings.ctrl[i] != SPELLING_EMPTY)
+			bad_spellings_sorted[j++] = spellings.slots[i].word;
 	}
 
-	qsort(bad_spellings_sorted, j, sizeof(char *), cmpstr);
+	qsort(bad_spellings_sorted, j, sizeof(*bad_spellings_sorted), cmpstr);
 
-	for (i = 0; i < bad_spellings; i++) {
-		register char *ptr = bad_spellings_sorted[i];
-		hash_entry_t *const he = (hash_entry_t *)(ptr - sizeof(hash_entry_t));
+	for (i = 0; i < j; i++) {
+		register const char *ptr = bad_spellings_sorted[i];
 		register char ch;
 
 		while ((ch = *(ptr++))) {
 			putchar(ch);
 		}
 		putchar('\n');
-
-		free(he);
 	}
 
 	free(bad_spellings_sorted);
+	spelling_table_free(&spellings);
 }
 
-static inline void load_printks(void)
+/*
+ *  Pick the fastest structural indexer and newline counter
+ *  this CPU supports
+ */
+static void set_scan_classify(void)
 {
-	size_t i;
-
-	for (i = 0; i < SIZEOF_ARRAY(printks); i++) {
-		add_word(printks[i], printk_nodes, printk_node_heap, &printk_node_heap_next, PRINTK_NODES_HEAP_SIZE);
+	scan_classify = scan_classify_generic;
+	count_newlines = count_newlines_generic;
+	index_newlines = index_newlines_generic;
+#if defined(HAVE_SCAN_X86)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		scan_classify = scan_classify_avx2;
+		count_newlines = count_newlines_avx2;
+		index_newlines = index_newlines_avx2;
+	} else if (__builtin_cpu_supports("sse2")) {
+		scan_classify = scan_classify_sse2;
+		count_newlines = count_newlines_sse2;
+		index_newlines = index_newlines_sse2;
 	}
+#endif
 }
 
-static void set_is_not_whitespace(void)
-{
-	memset(is_not_whitespace, true, sizeof(is_not_whitespace));
-	is_not_whitespace[' '] = false;
-	is_not_whitespace['\t'] = false;
-}
-
-static void set_is_not_identifier(void)
+/*
+ *  Use popcnt for dictionary lookups if this CPU has it,
+ *  and lockstep lookups if set_dict_lanes() asked for them
+ */
+static void set_check_words(void)
 {
-	size_t i;
-
-	memset(is_not_identifier, true, sizeof(is_not_identifier));
-	for (i = 0; i < 26; i++) {
-		is_not_identifier[i + 'a'] = false;
-		is_not_identifier[i + 'A'] = false;
-	}
-	for (i = 0; i < 10; i++) {
-		is_not_identifier[i + '0'] = false;
+	const bool lanes = dict_lanes > 1;
+
+	dict_find_word = dict_find_word_generic;
+	check_unique_words = lanes ? check_unique_words_generic_lanes : check_unique_words_generic;
+#if defined(HAVE_SCAN_X86)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("popcnt")) {
+		dict_find_word = dict_find_word_popcnt;
+		check_unique_words = lanes ? check_unique_words_popcnt_lanes : check_unique_words_popcnt;
 	}
-	is_not_identifier['_'] = false;
+#endif
 }
 
 /*
@@ -4114,17 +5929,26 @@ static void set_is_not_identifier(void)
  */
 int main(int argc, char **argv)
 {
-	token_t t, line, str;
 	double t1, t2;
+	uint32_t i;
 	static char buffer[65536];
+	static const struct option long_options[] = {
+		{ "compile-dict",	required_argument,	NULL,	LONG_OPT_COMPILE_DICT },
+		{ "dict-benchmark",	no_argument,		NULL,	LONG_OPT_DICT_BENCHMARK },
+		{ NULL,			0,			NULL,	0 }
+	};
+	const char *compile_dict_in = NULL, *compile_dict_out = NULL;
 	
 	token_cat = token_cat_normal;
 
 	for (;;) {
-		int c = getopt(argc, argv, "cd:efhklnsx");
+		int c = getopt_long(argc, argv, "acd:efhj:klm:npr:suw:x", long_options, NULL);
 		if (c == -1)
  			break;
 		switch (c) {
+		case 'a':
+			opt_flags |= OPT_CHECK_FORMAT;
+			break;
 		case 'c':
 			opt_flags |= OPT_CHECK_WORDS;
 			break;
@@ -4140,6 +5964,13 @@ int main(int argc, char **argv)
 		case 'h':
 			show_usage();
 			exit(EXIT_SUCCESS);
+		case 'j':
+			jobs = (uint32_t)strtoul(optarg, NULL, 10);
+			if ((jobs < 1) || (jobs > 1024)) {
+				fprintf(stderr, "Number of jobs must be 1..1024\n");
+				exit(EXIT_FAILURE);
+			}
+			break;
 		case 'k':
 			opt_flags |= (OPT_CHECK_WORDS |
 				      OPT_ESCAPE_STRIP |
@@ -4151,75 +5982,180 @@ int main(int argc, char **argv)
 		case 'l':
 			opt_flags |= OPT_PARSE_STRINGS;
 			break;
+		case 'm':
+			opt_flags |= OPT_DMESG;
+			dmesg_path = optarg;
+			break;
 		case 'n':
 			opt_flags |= OPT_MISSING_NEWLINE;
 			break;
+		case 'p':
+			opt_flags |= OPT_POSITION;
+			break;
+		case 'r':
+			read_threshold = (size_t)strtoull(optarg, NULL, 10);
+			break;
 		case 's':
 			opt_flags |= OPT_LITERAL_STRINGS;
 			token_cat = token_cat_just_literal_string;
 			break;
+		case 'u':
+			opt_flags |= OPT_IO_URING;
+			break;
+		case 'w':
+			walkers = (uint32_t)strtoul(optarg, NULL, 10);
+			if ((walkers < 1) || (walkers > 1024)) {
+				fprintf(stderr, "Number of walkers must be 1..1024\n");
+				exit(EXIT_FAILURE);
+			}
+			break;
 		case 'x':
 			opt_flags &= ~OPT_SOURCE_NAME;
 			break;
+		case LONG_OPT_COMPILE_DICT:
+			if (optind >= argc) {
+				fprintf(stderr, "--compile-dict needs a word list and an image file\n");
+				exit(EXIT_FAILURE);
+			}
+			compile_dict_in = optarg;
+			compile_dict_out = argv[optind++];
+			break;
+		case LONG_OPT_DICT_BENCHMARK:
+			dict_benchmark = true;
+			break;
 		default:
 			show_usage();
 			exit(EXIT_FAILURE);
 		}
 	}
 
-	set_is_not_whitespace();
-	set_is_not_identifier();
+	/* -m needs the formats as written, escapes and all */
+	if (opt_flags & OPT_DMESG)
+		opt_flags &= ~(OPT_PARSE_STRINGS | OPT_CHECK_WORDS |
+			       OPT_ESCAPE_STRIP | OPT_FORMAT_STRIP |
+			       OPT_LITERAL_STRINGS);
+	parse_func = (opt_flags & OPT_PARSE_STRINGS) ?
+		parse_literal_strings : parse_kernel_messages;
+
+	set_scan_classify();
+	set_check_words();
 
-	set_mapping();
-	load_printks();
-	(void)qsort(formats, SIZEOF_ARRAY(formats), sizeof(format_t), cmp_format);
+	if (compile_dict_in) {
+		exit(compile_dictionary(compile_dict_in, compile_dict_out) ?
+			EXIT_FAILURE : EXIT_SUCCESS);
+	}
 	if (opt_flags & OPT_CHECK_WORDS) {
 		int ret;
 
 		ret = read_dictionary(dictionary_path);
 		if (ret) {
-			fprintf(stderr, "No dictionary found, expecting words in %s\n", dictionary_path);
+			/* -2 is a bad dictionary image, already reported */
+			if (ret == -1)
+				fprintf(stderr, "No dictionary found, expecting words in %s\n", dictionary_path);
 			exit(EXIT_FAILURE);
 		}
+		set_dict_lanes();
+		set_check_words();
 	}
 
-	token_new(&t);
-	token_new(&line);
-	token_new(&str);
+	if (posix_memalign((void **)&workers, 64, jobs * sizeof(*workers)))
+		out_of_memory();
+	memset(workers, 0, jobs * sizeof(*workers));
+	worker_new(&workers[0], &spellings);
+	for (i = 1; i < jobs; i++) {
+		spelling_table_t *table = calloc(1, sizeof(*table));
+
+		if (!table)
+			out_of_memory();
+		worker_new(&workers[i], table);
+	}
+	for (i = 0; i < jobs; i++)
+		workers[i].id = i;
+
+	walk_contexts = calloc(walkers, sizeof(*walk_contexts));
+	walk_pool.dirs = calloc(walkers, sizeof(*walk_pool.dirs));
+	if (!walk_contexts || !walk_pool.dirs)
+		out_of_memory();
+#if defined(HAVE_IO_URING)
+	/* Silently fall back to mmap'ing files if io_uring is not available */
+	if (opt_flags & OPT_IO_URING) {
+		for (i = 0; i < walkers; i++) {
+			walk_contexts[i].uring = uring_new();
+			if (!walk_contexts[i].uring)
+				break;
+		}
+	}
+#endif
 
 	fflush(stdout);
 	setvbuf(stdout, buffer, _IOFBF, sizeof(buffer));
 
 	t1 = gettime_to_double();
 	while (argc > optind) {
-		parse_path(argv[optind], &t, &line, &str);
+		parse_path(argv[optind]);
 		optind++;
 	}
 	t2 = gettime_to_double();
 
-	token_free(&str);
-	token_free(&line);
-	token_free(&t);
+	for (i = 0; i < jobs; i++)
+		worker_merge(&workers[i]);
+#if defined(HAVE_IO_URING)
+	for (i = 0; i < walkers; i++)
+		uring_free(walk_contexts[i].uring);
+#endif
+	pool_free();
 
 	dump_bad_spellings();
+	if (opt_flags & OPT_DMESG)
+		dmesg_lookup(dmesg_path);
+
+	/* the bad spellings and formats live in the arenas */
+	for (i = 0; i < jobs; i++)
+		worker_free(&workers[i]);
+	free(workers);
+	for (i = 0; i < walkers; i++) {
+		walk_dirents_free(&walk_contexts[i]);
+		arena_free(&walk_contexts[i].arena);
+	}
+	free(walk_pool.dirs);
+	free(walk_contexts);
 
 	printf("\n%" PRIu32 " files scanned\n", files);
 	printf("%" PRIu32 " lines scanned (%.3f"  " Mbytes)\n",
 		lines, (float)bytes_total / (float)(1024 * 1024));
 	printf("%" PRIu32 " print statements found\n", finds);
 	if (words) {
-		size_t nodes = word_node_heap_next - word_node_heap;
-		printf("%" PRIu32 " words and %zd nodes in dictionary heap\n",
-			words, nodes);
+		const size_t bytes = dawg_size();
+
+		printf("%" PRIu32 " words, %" PRIu32 " nodes and %" PRIu32
+			" edges in dictionary DAWG\n",
+			words, dawg_node_count, dawg_edge_count);
 		printf("%" PRIu32 " chars mapped to %zd bytes of heap, ratio=1:%.2f\n",
-			dict_size, nodes * sizeof(word_node_t),
-			(float)nodes * sizeof(word_node_t) / dict_size);
+			dict_size, bytes, (float)bytes / dict_size);
+		if (dawg_lookup_rate > 0.0)
+			printf("%.2f dictionary lookups per second\n", dawg_lookup_rate);
 	}
-	printf("%zu printk style statements being searched\n",
-		SIZEOF_ARRAY(printks));
+	printf("%d printk style statements being searched\n",
+		PRINTK_HASH_SIZE);
 	if (bad_spellings)
 		printf("%" PRIu32 " unique bad spellings found (%" PRIu32 " non-unique)\n",
 			bad_spellings, bad_spellings_total);
+	if (opt_flags & OPT_CHECK_FORMAT)
+		printf("%" PRIu32 " format argument mismatches found\n", format_mismatches);
+	if (opt_flags & OPT_DMESG) {
+		printf("%" PRIu32 " message format lines indexed in %" PRIu32
+			" automaton nodes (%" PRIu32 " too short to index)\n",
+			dmesg_indexed, dmesg_nodes_used, dmesg_unindexed);
+		printf("%" PRIu32 " of %" PRIu32 " log lines matched\n",
+			dmesg_lines_matched, dmesg_lines);
+	}
+	if (arena_totals.nblocks)
+		printf("%" PRIu64 " arena allocations, %.3f Mbytes in %" PRIu64
+			" blocks (%.1f%% used)\n",
+			arena_totals.allocs,
+			(double)arena_totals.block_bytes / (double)(1024 * 1024),
+			arena_totals.nblocks,
+			100.0 * (double)arena_totals.bytes / (double)arena_totals.block_bytes);
 	printf("scanned %.2f lines per second\n",
 		FLOAT_CMP(t1, t2) ? 0.0 : (double)lines / (t2 - t1));
 	printf("(kernelscan " VERSION ")\n");
@@ -0,0 +1,2851 @@
+/*
+ * Copyright (C) 2012-2020 Canonical
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/*
+ *  Build time generator of the static tables kernelscan
+ *  uses, the tables are written to stdout as C source.
+ *  With no arguments this writes kernelscan-tables.h, with
+ *  "formats" it writes kernelscan-formats.h, the format
+ *  specifiers the format DFA is built from
+ */
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <ctype.h>
+
+#define SIZEOF_ARRAY(x)		(sizeof(x) / sizeof(x[0]))
+
+#define PRINTK_HASH_BITS	(10)	/* log2 of perfect hash buckets */
+#define PRINTK_HASH_BUCKETS	(1U << PRINTK_HASH_BITS)
+#define PRINTK_HASH_TRIES	(65536)	/* displacements tried per bucket */
+
+#define BAD_MAPPING		(0xff)
+#define FORMAT_STATES_MAX	(256)	/* format DFA states fit in a uint8_t */
+#define FORMAT_START		(1)	/* format DFA start state */
+#define FORMAT_PREFIX		(0xff)	/* format DFA accepting flags, width, precision */
+
+/*
+ *  Kernel printk format specifiers
+ */
+static const char *formats[] = {
+	"%",
+	"s",
+	"llu",
+	"lld",
+	"llx",
+	"llX",
+	"lu",
+	"ld",
+	"lx",
+	"lX",
+	"u",
+	"d",
+	"x",
+	"X",
+	"pF",
+	"pf",
+	"ps",
+	"pSR",
+	"pS",
+	"pB",
+	"pK",
+	"pr",
+	"pap",
+	"pa",
+	"pad",
+	"*pE",
+	"*pEa",
+	"*pEc",
+	"*pEh",
+	"*pEn",
+	"*pEo",
+	"*pEp",
+	"*pEs",
+	"*ph",
+	"*phC",
+	"*phD",
+	"*phN",
+	"pM",
+	"pMR",
+	"pMF",
+	"pm",
+	"pmR",
+	"pi4",
+	"pI4",
+	"pi4h",
+	"pI4h",
+	"pi4n",
+	"pI4n",
+	"pi4b",
+	"pI4b",
+	"pi4l",
+	"pI4l",
+	"pi6",
+	"pI6",
+	"pI6c",
+	"piS",
+	"pIS",
+	"piSc",
+	"pISc",
+	"piSpc",
+	"pISpc",
+	"piSf",
+	"pISf",
+	"piSs",
+	"pISs",
+	"piSh",
+	"pISh",
+	"piSn",
+	"pISn",
+	"piSb",
+	"pISb",
+	"piSl",
+	"pISl",
+	"pUb",
+	"pUB",
+	"pUl",
+	"pUL",
+	"pd",
+	"pd2",
+	"pd3",
+	"pd4",
+	"pD",
+	"pD2",
+	"pD3",
+	"pD4",
+	"pg",
+	"pV",
+	"pC",
+	"pCn",
+	"pCr",
+	"*pb",
+	"*pbl",
+	"pGp",
+	"pGg",
+	"pGv",
+	"pNF",
+};
+
+/*
+ *  various printk like functions, kernelscan looks for
+ *  calls to these with a minimal perfect hash
+ */
+static const char *printks[] = {
+	"AA_BUG",
+	"AA_DEBUG",
+	"AA_ERROR",
+	"aa_info_message",
+	"ABIT_UGURU3_DEBUG",
+	"ACPI_BIOS_ERROR",
+	"ACPI_BIOS_WARNING",
+	"ACPI_DEBUG_PRINT",
+	"ACPI_DEBUG_PRINT_RAW",
+	"ACPI_ERROR",
+	"ACPI_ERROR_METHOD",
+	"ACPI_EXCEPTION",
+	"ACPI_INFO",
+	"acpi_handle_debug",
+	"acpi_handle_err",
+	"acpi_handle_info",
+	"acpi_handle_warn",
+	"acpi_os_printf",
+	"ACPI_WARNING",
+	"ADBG",
+	"adc_dbg",
+	"adfs_error",
+	"adsp_dbg",
+	"adsp_err",
+	"adv_dbg",
+	"adv_err",
+	"affs_warning",
+	"aha152x_error",
+	"airo_print_dbg",
+	"airo_print_err",
+	"airo_print_info",
+	"airo_print_warn",
+	"amd64_err",
+	"amd64_info",
+	"amd64_notice",
+	"amd64_warn",
+	"apic_debug",
+	"apic_printk",
+	"apm_error",
+	"APRINTK",
+	"aq_pr_err",
+	"ar5523_dbg",
+	"ar5523_err",
+	"ar5523_info",
+	"arizona_aif_dbg",
+	"arizona_aif_err",
+	"arizona_aif_warn",
+	"arizona_fll_dbg",
+	"arizona_fll_err",
+	"arizona_fll_warn",
+	"arm64_notify_die",
+	"arm_notify_die",
+	"arc_printk",
+	"ASC_DBG",
+	"ASC_PRINT",
+	"ASD_DPRINTK",
+	"asd_printk",
+	"asprintf",
+	"at76_dbg",
+	"ata_dev_dbg",
+	"ata_dev_err",
+	"ata_dev_info",
+	"ata_dev_notice",
+	"ata_dev_printk",
+	"ata_dev_warn",
+	"ata_link_dbg",
+	"ata_link_err",
+	"ata_link_info",
+	"ata_link_notice",
+	"ata_link_printk",
+	"ata_link_warn",
+	"ata_link_warn",
+	"ata_port_dbg",
+	"ata_port_desc",
+	"ata_port_err",
+	"ata_port_info",
+	"ata_port_notice",
+	"ata_port_printk",
+	"ata_port_warn",
+	"ata_dev_warn",
+	"ATH5K_PRINTF",
+	"ath10k_dbg",
+	"ath10k_err",
+	"ath10k_info",
+	"ath10k_warn",
+	"ATH5K_DBG",
+	"ATH5K_DBG_UNLIMIT",
+	"ATH5K_ERR",
+	"ATH5K_INFO",
+	"ATH5K_PRINTF",
+	"ATH5K_PRINTK",
+	"ATH5K_WARN",
+	"ath6kl_dbg",
+	"ath6kl_err",
+	"ath6kl_info",
+	"ath6kl_warn",
+	"ath_dbg",
+	"ath_err",
+	"ath_info",
+	"atm_dbg",
+	"atm_err",
+	"atm_info",
+	"atm_printk",
+	"atm_rldbg",
+	"atm_warn",
+	"au0828_isocdbg",
+	"audio_debug",
+	"audio_error",
+	"audio_info",
+	"audio_warning",
+	"audit_log_config_change",
+	"audit_log_link_denied",
+	"audit_log_lost",
+	"audit_log_rule_change",
+	"audit_panic",
+	"audit_printk",
+	"AUX_DBG",
+	"AUX_ERR",
+	"AUX_TRACE",
+	"b43dbg",
+	"b43err",
+	"b43info",
+	"b43warn",
+	"b43legacydbg",
+	"b43legacyerr",
+	"b43legacyinfo",
+	"b43legacywatn",
+	"batadv_dbg",
+	"batadv_dbg_arp",
+	"batadv_err",
+	"batadv_info",
+	"batadv_warn",
+	"bcma_debug",
+	"bcma_err",
+	"bcma_info",
+	"bcma_warn",
+	"bdebug",
+	"befs_debug",
+	"befs_error",
+	"bit_dbg",
+	"bfq_log",
+	"bfq_log_bfqq",
+	"binder_debug",
+	"binder_user_error",
+	"blogic_announce",
+	"blogic_err",
+	"blogic_info",
+	"blogic_notice",
+	"blogic_warn",
+	"BNX2FC_ELS_DBG",
+	"BNX2FC_HBA_DBG",
+	"BNX2FC_IO_DBG",
+	"BNX2FC_MISC_DBG",
+	"BNX2FC_TGT_DBG",
+	"BNX2X_DEV_INFO",
+	"BNX2X_ERR",
+	"BNX2X_ERROR",
+	"bootx_printf",
+	"brcmf_dbg",
+	"brcmf_dbg_info",
+	"brcmf_dbg_tx",
+	"brcmf_err",
+	"brcmf_info",
+	"brcmf_helper",
+	"brcms_dbg_dma",
+	"brcms_dbg_ht",
+	"brcms_dbg_info",
+	"brcms_dbg_int",
+	"brcms_dbg_mac80211",
+	"brcms_dbg_rx",
+	"brcms_dbg_tx",
+	"brcms_err",
+	"br_debug",
+	"br_err",
+	"br_info",
+	"br_notice",
+	"bsg_dbg",
+	"BTC_PRINT",
+	"BT_DBG",
+	"bt_dev_dbg",
+	"bt_dev_err",
+	"bt_dev_err_ratelimited",
+	"bt_dev_info",
+	"bt_dev_warn",
+	"BTE_PRINTK",
+	"BTE_PRINTKV",
+	"BT_ERR",
+	"BT_ERR_RATELIMITED",
+	"BT_INFO",
+	"BT_WARN",
+	"btrfs_crit",
+	"btrfs_debug",
+	"btrfs_err",
+	"btrfs_err_rl",
+	"btrfs_info",
+	"btrfs_warn",
+	"BUF_PRINT",
+	"buf_printf",
+	"BUGFIX",
+	"BUGON",
+	"BUG_ON",
+	"BUGPRINT",
+	"BUS_DBG",
+	"cache_bug",
+	"cafe_dev_dbg",
+	"cal_dbg",
+	"cal_err",
+	"cal_info",
+	"cam_dbg",
+	"cam_err",
+	"cam_warn",
+	"cat_printf",
+	"ccid2_pr_debug",
+	"ccid3_pr_debug",
+	"cd_dbg",
+	"c_dbg",
+	"CDEBUG",
+	"c_err",
+	"ceph_iod_printf",
+	"CERROR",
+	"cfq_log",
+	"cfq_log_cfqq",
+	"ch7006_dbg",
+	"ch7006_err",
+	"ch7006_info",
+	"chan_dbg",
+	"chan_err",
+	"CH_DBG",
+	"CH_ERR",
+	"CH_WARN",
+	"CHECK",
+	"chip_dbg",
+	"chip_err",
+	"CHSC_LOG",
+	"ci_dbg",
+	"ci_dbg_print",
+	"cifs_dbg",
+	"cl_dbg",
+	"cl_err",
+	"cmm_dbg",
+	"cmp_error",
+	"CNETERR",
+	"cobalt_dbg",
+	"cobalt_err",
+	"cobalt_info",
+	"cobalt_warn",
+	"codec_dbg",
+	"codec_err",
+	"codec_info",
+	"codec_warn",
+	"color_fprintf",
+	"conf_message",
+	"conf_printf",
+	"conf_warning",
+	"con_log",
+	"CONN_DBG",
+	"CONN_ERR",
+	"cont",
+	"core_dbg",
+	"cow_printf",
+	"cpc925_mc_printk",
+	"cpc925_printk",
+	"cpsw_err",
+	"cpsw_info",
+	"cpsw_notice",
+	"CS_DBGOUT",
+	"cs89_dbg",
+	"csio_dbg",
+	"csio_err",
+	"csio_warn",
+	"csio_ln_dbg",
+	"csio_ln_err",
+	"ctcm_pr_debug",
+	"CTCM_PR_DEBUG",
+	"ctrl_dbg",
+	"ctrl_err",
+	"ctrl_info",
+	"ctrl_warn",
+	"ctx_dbg",
+	"ctx_err",
+	"CWARN",
+	"cvmx_dprintf",
+	"CX18_ALSA_ERR",
+	"CX18_ALSA_WARN",
+	"CX18_DEBUG_ALSA_INFO",
+	"CX18_DEBUG_API",
+	"CX18_DEBUG_FILE",
+	"CX18_DEBUG_HI_API",
+	"CX18_DEBUG_HI_DMA",
+	"CX18_DEBUG_HI_FILE",
+	"CX18_DEBUG_HI_IRQ",
+	"CX18_DEBUG_INFO",
+	"CX18_DEBUG_IOCTL",
+	"CX18_DEBUG_WARN",
+	"CX18_ERR",
+	"CX18_INFO",
+	"CX18_WARN",
+	"cx231xx_coredbg",
+	"cx231xx_isocdbg",
+	"cx231xx_videodbg",
+	"CX25821_ERR",
+	"CX25821_INFO",
+	"cx_err",
+	"cx_info",
+	"d40_err",
+	"d2printk",
+	"DAC960_Announce",
+	"DAC960_Critical",
+	"DAC960_Error",
+	"DAC960_Info",
+	"DAC960_Notice",
+	"DAC960_Progress",
+	"DAC960_UserCritical",
+	"DAC960_Warning",
+	"dax_dbg",
+	"dax_err",
+	"DB_CFM",
+	"DB_CFMN",
+	"DB_ECM",
+	"DB_ECMN",
+	"DB_ESS",
+	"DB_ESSN",
+	"DBF_DEV_EVENT",
+	"DBF_ERROR",
+	"DBF_EVENT",
+	"DBF_EVENT",
+	"DBF_EXCEPTION",
+	"dbg",
+	"_DBG",
+	"DBG",
+	"DBG1",
+	"DBG2",
+	"DBG3",
+	"DBG4",
+	"DBG_8192C",
+	"DBG_8712",
+	"DBG_871X",
+	"DBG_871X_LEVEL",
+	"DBG_88E",
+	"DBG_88E_LEVEL",
+	"DBGA",
+	"DBGA2",
+	"DBGBH",
+	"DBGC",
+	"dbg_bld",
+	"dbg_blit",
+	"dbg_budg",
+	"DBG_BYPASS",
+	"DBG_CFG",
+	"DBG_CMD",
+	"dbg_cmt",
+	"DBG_CNT",
+	"DBGDCONT",
+	"dbg_dentlist",
+	"DBG_DEVS",
+	"dbg_dump",
+	"dbg_eba",
+	"DB_GEN",
+	"DBGERR",
+	"DBG_ERR",
+	"dbg_find",
+	"dbg_fmt",
+	"dbg_fragtree",
+	"dbg_fragtree2",
+	"dbg_fsbuild",
+	"DBGFS_DUMP",
+	"DBGFS_DUMP_DI",
+	"DBGFS_PRINT_INT",
+	"DBGFS_PRINT_STR",
+	"DBG_FTL",
+	"dbg_gc",
+	"dbg_gen",
+	"dbg_hid",
+	"dbg_info",
+	"DBGINFO",
+	"DBG_INIT",
+	"dbg_inocache",
+	"dbg_io",
+	"DBG_IRT",
+	"DBGISR",
+	"dbg_jnl",
+	"dbg_jnlk",
+	"dbg_log",
+	"DBG_LOG",
+	"DBG_LOTS",
+	"DBG_LOUD",
+	"DBG_LOW",
+	"dbg_lp",
+	"dbg_memalloc",
+	"dbg_mnt",
+	"dbg_mntk",
+	"DBG_MSG",
+	"dbg_noderef",
+	"DBG_PAT",
+	"DBG_PORT",
+	"dbgp_ehci_status",
+	"dbg_pnp_show_resources",
+	"dbgp_printk",
+	"DBGPR",
+	"dbgprint",
+	"DbgPrint",
+	"DBG_printk",
+	"DBG_PRV1",
+	"dbg_qtd",
+	"dbg_rcvry",
+	"dbg_readinode",
+	"dbg_readinode2",
+	"dbg_reg",
+	"dbg_regs",
+	"DBG_REG",
+	"DbgRegister",
+	"DBG_RES",
+	"DBG_RUN",
+	"DBG_RUN_SG",
+	"DBGS",
+	"dbg_scan",
+	"dbg_summary",
+	"dbg_td",
+	"dbg_tnc",
+	"dbg_tnck",
+	"DBG_TRC",
+	"dbg_verbose",
+	"DBG_VERBOSE",
+	"dbg_wl",
+	"dbg_xattr",
+	"DBMSG",
+	"DBP_SAVE",
+	"DB_PCM",
+	"DB_RMT",
+	"DB_RMTN",
+	"DB_RX",
+	"DB_SMT",
+	"DB_SNMP",
+	"DB_TX",
+	"dbug",
+	"DCCP_BUG",
+	"DCCP_CRIT",
+	"dccp_debug",
+	"dccp_pr_debug",
+	"dccp_pr_debug_cat",
+	"DCCP_WARN",
+	"DC_ERR",
+	"DC_ERROR",
+	"dcprintk",
+	"dctlprintk",
+	"DDB",
+	"dd_dev_dbg",
+	"dd_dev_err",
+	"dd_dev_info",
+	"dd_dev_info_ratelimited",
+	"dd_dev_warn",
+	"ddlprintk",
+	"ddprintk",
+	"ddprintk_cont",
+	"deb",
+	"DEB",
+	"DEB1",
+	"DEB2",
+	"DEB3",
+	"DEB_CAP",
+	"deb_chk",
+	"DEB_D",
+	"DEBC_printk",
+	"deb_data",
+	"deb_decode",
+	"DEB_EE",
+	"deb_eeprom",
+	"deb_err",
+	"deb_fe",
+	"deb_fw",
+	"deb_fwdata",
+	"deb_fw_load",
+	"DEBG",
+	"DEB_G",
+	"deb_getf",
+	"deb_hab",
+	"deb_i2c",
+	"DEB_I2C",
+	"deb_i2c_read",
+	"deb_i2c_write",
+	"deb_info",
+	"DEB_INT",
+	"deb_irq",
+	"deb_mem",
+	"DEBPRINT",
+	"DEBPRINTK",
+	"deb_rc",
+	"deb_rdump",
+	"deb_readreg",
+	"deb_reg",
+	"DEB_S",
+	"deb_setf",
+	"deb_sram",
+	"deb_srch",
+	"deb_ts",
+	"deb_tuner",
+	"_debug",
+	"debug",
+	"DEBUG",
+	"DEBUG2",
+	"DEBUG3",
+	"DEBUG_API",
+	"DEBUG_AUTOCONF",
+	"debug_badness",
+	"DEBUG_bytes",
+	"debug_cclk_get",
+	"DEBUG_DBG",
+	"debug_dcl",
+	"DEBUG_ERR",
+	"_debug_bug_printk",
+	"DEBUG_INFO",
+	"DEBUG_IRQ",
+	"debugl1",
+	"debug_log",
+	"DEBUG_LOG",
+	"DEBUG_MARKER",
+	"debug_msg",
+	"DEBUG_MSG",
+	"debug_name",
+	"DEBUGOUTBUF",
+	"DEBUGP",
+	"debug_pci",
+	"debug_polling",
+	"DEBUG_print",
+	"debug_printf",
+	"debug_print_fifo_channel_state",
+	"debug_print_if_state",
+	"debug_print_isp_state",
+	"debug_print_object",
+	"debug_print_rmap",
+	"debug_print_sp_state",
+	"debug_putstr",
+	"DEBUGREAD",
+	"DEBUG_REQ",
+	"debug_shrink_set",
+	"debug_sprintf_event",
+	"debug_sprintf_exception",
+	"DEBUGTRDMA",
+	"DEBUGTXINT",
+	"debug_timestamp",
+	"DEBUGTXINT",
+	"DEBUG_VAE",
+	"DEBUG_WARN",
+	"DEBUGWRITE",
+	"deb_uxfer",
+	"deb_v8",
+	"DEB_VBI",
+	"deb_xfer",
+	"decrypt_done",
+	"decrypt_fail",
+	"decrypt_interrupt",
+	"D_EEPROM",
+	"DERROR",
+	"dev",
+	"dev_alert",
+	"dev_alert_once",
+	"dev_alert_ratelimited",
+	"dev_crit",
+	"dev_crit_once",
+	"dev_crit_ratelimited",
+	"dev_dbg",
+	"dev_dbgdma",
+	"deb_dbg_f",
+	"deb_dbg_lvl",
+	"deb_dbg_ratelimited",
+	"deb_dbg_stamp",
+	"dev_dbg_once",
+	"dev_emerg",
+	"dev_emerg_once",
+	"dev_emerg_ratelimited",
+	"dev_err",
+	"dev_err_console",
+	"dev_err_once",
+	"dev_err_ratelimited",
+	"dev_info",
+	"dev_info_once",
+	"dev_info_ratelimited",
+	"dev_level_once",
+	"dev_level_ratelimited",
+	"dev_notice",
+	"dev_notice_once",
+	"dev_notice_ratelimited",
+	"dev_printk",
+	"dev_printk_emit",
+	"dev_vprintk_emit",
+	"dev_warn",
+	"dev_warn_once",
+	"dev_warn_ratelimited",
+	"devtprintk",
+	"devtverboseprintk",
+	"dev_vdbg",
+	"dev_warn",
+	"dev_WARN",
+	"dev_warn_once",
+	"dev_WARN_ONCE",
+	"dev_warn_ratelimited",
+	"dewtprintk",
+	"dexitprintk",
+	"dfailprintk",
+	"dfprintk",
+	"dhsprintk",
+	"df_trace",
+	"die",
+	"dio_on",
+	"__die_if_kernel",
+	"die_if_kernel",
+	"die_if_no_fixup",
+	"die_nmi",
+	"dintprintk",
+	"dioprintk",
+	"D_INFO",
+	"DIPRINTK",
+	"D_ISR",
+	"diva_log_info",
+	"D_LED",
+	"dlog",
+	"dlprintk",
+	"dm9000_dbg",
+	"DMCRIT",
+	"DMDEBUG",
+	"DMDEBUG_LIMIT",
+	"DMEMIT",
+	"DMERR",
+	"DMERR_LIMIT",
+	"DMESG",
+	"DMESGE",
+	"dmfprintk",
+	"DMINFO",
+	"DMSG",
+	"DMWARN",
+	"DMWARN_LIMIT",
+	"dmz_dev_debug",
+	"dmz_dev_err",
+	"dn_serial_print",
+	"do_BUG",
+	"doc_dbg",
+	"doc_err",
+	"doc_info",
+	"doc_vdbg",
+	"do_error",
+	"do_trap",
+	"do_warning",
+	"do_warning_event",
+	"dout",
+	"DP",
+	"DP_CONT",
+	"DPC",
+	"DPD",
+	"DPD1",
+	"DP_DEBUG",
+	"DP_ERR",
+	"DP_INFO",
+	"DP_VERBOSE",
+	"DPE",
+	"DPE1",
+	"D_POWER",
+	"dprint",
+	"DPRINT",
+	"DPRINT_CONFIG",
+	"dprintf",
+	"Dprintf",
+	"DPRINTF",
+	"dprintf0",
+	"dprintf1",
+	"dprintf2",
+	"dprintf3",
+	"dprintf4",
+	"dprintf5",
+	"dprintk",
+	"Dprintk",
+	"DPRINTK",
+	"dprintk0",
+	"dprintk1",
+	"dprintk2",
+	"dprintkdbg",
+	"dprintk_cont",
+	"dprintk_i2c",
+	"dprintkl",
+	"dprintk_mmu",
+	"dprintk_pte",
+	"dprintk_rcu",
+	"dprintk_sect_loss",
+	"dprintk_sr",
+	"dprintk_tscheck",
+	"DPRINT_ovfl",
+	"DPRINT_TLA",
+	"DPS",
+	"DPS1",
+	"DPX",
+	"DPX1",
+	"D_QOS",
+	"D_RADIO",
+	"D_RATE",
+	"D_RF_KILL",
+	"drbd_alert",
+	"drbd_dbg",
+	"drbd_emerg",
+	"drbd_err",
+	"drbd_info",
+	"drbd_warn",
+	"dreplyprintk",
+	"DRM_DEBUG",
+	"DRM_DEBUG_ATOMIC",
+	"DRM_DEBUG_DRIVER",
+	"DRM_DEBUG_KMS",
+	"DRM_DEBUG_KMS_RATELIMITED",
+	"DRM_DEBUG_LEASE",
+	"DRM_DEBUG_PRIME",
+	"DRM_DEBUG_VBL",
+	"DRM_DEV_DEBUG_KMS",
+	"DRM_DEV_ERROR",
+	"DRM_ERROR",
+	"DRM_ERROR_RATELIMITED",
+	"DRM_INFO",
+	"DRM_INFO_ONCE",
+	"DRM_NODE",
+	"DRM_NOTE",
+	"DRM_WARN",
+	"drm_rect_debug_print",
+	"drm_printf",
+	"drm_printf_indent",
+	"dsb",
+	"dsasprintk",
+	"dsawideprintk",
+	"dsgprintk",
+	"dsprintk",
+	"D_SCAN",
+	"DSSDBG",
+	"DSSERR",
+	"DSSWARN",
+	"D_STATS",
+	"D_TEMP",
+	"DTN_INFO",
+	"dtmprink",
+	"dtrc",
+	"D_TX",
+	"DTX",
+	"D_TXPOWER",
+	"D_TX_REPLY",
+	"dump_printf",
+	"DUMP_printk",
+	"dump_stack_set_arch_desc",
+	"DUMP_VALUE",
+	"DWC2_TRACE_SCHEDULER",
+	"DWC2_TRACE_SCHEDULER_VB",
+	"D_WEP",
+	"dxtrace",
+	"dynamic_pr_debug",
+	"dynamic_hex_dump",
+	"E",
+	"e752x_printk",
+	"e7xxx_printk",
+	"ea_bdebug",
+	"ea_idebug",
+	"earlier",
+	"early_panic",
+	"early_pgtable_allocfail",
+	"early_platform_driver_probe",
+	"early_platform_driver_register_all",
+	"early_print",
+	"early_printk",
+	"ec_dbg_drv",
+	"ec_dbg_evt",
+	"ec_dbg_raw",
+	"ec_dbg_req",
+	"ec_dbg_stm",
+	"ec_log_drv",
+	"ecryptfs_printk",
+	"edac_dbg",
+	"edac_mc_handle_error",
+	"edac_mc_printk",
+	"edac_printk",
+	"e_dbg",
+	"e_dev_err",
+	"e_dev_info",
+	"e_dev_warn",
+	"e_err",
+	"EE",
+	"efi_printk",
+	"efm32_spi_vdbg",
+	"efm_debug",
+	"ehci_dbg",
+	"ehci_err",
+	"ehci_info",
+	"ehci_node",
+	"ehci_off",
+	"ehci_warn",
+	"ehci_dump",
+	"e_info",
+	"EISA_DBG",
+	"elantech_debug",
+	"em28xx_isocdbg",
+	"em28xx_regdbg",
+	"em28xx_videodbg",
+	"en_dbg",
+	"en_err",
+	"en_info",
+	"en_warn",
+	"ep_dbg",
+	"ep_err",
+	"ep_info",
+	"ep_vdbg",
+	"ep_warn",
+	"EP_INFO",
+	"eprintf",
+	"eprintk",
+	"ep_warn",
+	"err",
+	"ERR",
+	"err_chk",
+	"err_cpu",
+	"err_msg",
+	"ERR_MSG",
+	"error",
+	"ERROR",
+	"ErrorF",
+	"error_putstr",
+	"error_with_pos",
+	"err_printf",
+	"err_printk",
+	"err_puts",
+	"err_str",
+	"err_src",
+	"errx",
+	"esas2r_debug",
+	"esas2r_hdebug",
+	"esas2r_trace",
+	"esas2r_log",
+	"esas2r_log_dev",
+	"es_debug",
+	"esp_dma_log",
+	"esp_log_autosense",
+	"esp_log_cmddone",
+	"esp_log_command",
+	"esp_log_datadone",
+	"esp_log_datastart",
+	"esp_log_disconnect",
+	"esp_log_event",
+	"esp_log_intr",
+	"esp_log_msgin",
+	"esp_log_reconnect",
+	"esp_log_reset",
+	"esw_debug",
+	"esw_info",
+	"esw_warn",
+	"EVENT",
+	"e_warn",
+	"EXCEPTION",
+	"EXOFS_DBGMSG",
+	"EXOFS_DBGMSG2",
+	"EXOFS_ERR",
+	"ext2_debug",
+	"ext2_error",
+	"exy2_msg",
+	"ext4_abort",
+	"ext4_debug",
+	"ext4_error",
+	"ext4_lo_info",
+	"ext4_msg",
+	"ext4_warning",
+	"ext4_warning_inode",
+	"EXT4_ERROR_INODE",
+	"ext_debug",
+	"f2fs_cp_error",
+	"f2fs_msg",
+	"fail",
+	"fail_reason",
+	"FAIL",
+	"fatal",
+	"fatal_perror",
+	"fas216_log",
+	"fas216_log_target",
+	"fatal_perror",
+	"fat_fs_error",
+	"fat_msg",
+	"fb_dbg",
+	"fb_err",
+	"fb_info",
+	"fb_notice",
+	"fb_warn",
+	"fbtft_init_dbg",
+	"fbtft_par_dbg",
+	"fb_warn",
+	"FC_DISC_DBG",
+	"FC_EXCH_DBG",
+	"FC_RPORT_DBG",
+	"FC_SCSI_DBG",
+	"FC_FCP_DBG",
+	"FC_LPORT_DBG",
+	"FCOE_DBG",
+	"FCOE_NETDEV_DBG",
+	"FC_RPORT_ID_DBG",
+	"FCS_ONLINE",
+	"f_dddprintk",
+	"f_ddprintk",
+	"f_dprintk",
+	"fhci_dbg",
+	"fhci_err",
+	"fhci_info",
+	"fhci_vdbg",
+	"FIPS_DBG",
+	"FIPS_LOG",
+	"fit_dbg",
+	"fit_dbg_verbose",
+	"fit_pr",
+	"flow_dump",
+	"flow_log",
+	"fmdbg",
+	"fmerr",
+	"fmwarn",
+	"fotg210_dbg",
+	"fotg210_err",
+	"fotg210_info",
+	"fprintf",
+	"fputs",
+	"F_printk",
+	"fs_dprintk",
+	"fs_err",
+	"fs_info",
+	"fs_warn",
+	"fsl_mc_printk",
+	"fusb302_log",
+	"FW_BUG",
+	"fw_err",
+	"fw_notice",
+	"fwtty_dbg",
+	"fwtty_err",
+	"fwtty_err_ratelimited",
+	"fwtty_notice",
+	"gcam_dbg",
+	"gcam_err",
+	"gdbstub_printk",
+	"gfs2_print_dbg",
+	"gig_dbg",
+	"gossip_debug",
+	"gossip_err",
+	"gpio_mockup_err",
+	"gpiod_dbg",
+	"gdbstub_printk",
+	"gr_dbgprint_request",
+	"gru_abort",
+	"gru_dng",
+	"gspca_dbg",
+	"gspca_err",
+	"g_error",
+	"g_strdup_printf",
+	"gvt_dbg_cmd",
+	"gvt_dbg_core",
+	"gvt_dbg_el",
+	"gvt_dbg_irq",
+	"gvt_dbg_mm",
+	"gvt_dbg_mmio",
+	"gvt_dbg_render",
+	"gvt_dbg_sched",
+	"gvt_err",
+	"gvt_vgpu_err",
+	"hdmi_log",
+	"HEAD_DBG",
+	"hfi1_cdbg",
+	"hfi1_dbg_early",
+	"hfi1_early_err",
+	"hfi1_early_info",
+	"hfs_dbg",
+	"hfs_dbg_cont",
+	"hprintk",
+	"HPRINTK",
+	"hid_dbg",
+	"hid_debug_event",
+	"hid_err",
+	"hid_info",
+	"hid_warn",
+	"host1x_debug_output",
+	"hpfs_error",
+	"HPI_DEBUG_LOG",
+	"hprintk",
+	"HPRINTK",
+	"hpsa_show_dev_msg",
+	"hso_dbg",
+	"ht_dbg",
+	"ht_dbg_ratelimited",
+	"hwc_debug",
+	"hw_dbg",
+	"hw_err",
+	"hwc_debug",
+	"hw_dbg",
+	"i2c_cont",
+	"i2c_dbg",
+	"i2c_dprintk",
+	"i2c_hid_dbg",
+	"i40e_debug",
+	"i40iw_debug",
+	"i40iw_pr_err",
+	"i40iw_pr_info",
+	"i40iw_pr_warn",
+	"i5000_printk",
+	"i5400_printk",
+	"i7300_mc_printk",
+	"i7core_printk",
+	"i82875p_printk",
+	"i82975x_printk",
+	"i915_error_printf",
+	"I915_STATE_WARN",
+	"IA64_MCA_DEBUG",
+	"I915_STATE_WARN",
+	"IA_CSS_LOG",
+	"ia_css_print",
+	"IA_CSS_WARNING",
+	"IA64_MCA_DEBUG",
+	"ibmvfc_dbg",
+	"ibmvfc_log",
+	"ibss_dbg",
+	"icmp_error_log",
+	"icmpv6_error_log",
+	"ics_panic",
+	"ide_debug_log",
+	"ie31200_printk",
+	"IEEE80211_DEBUG",
+	"IEEE80211_DEBUG_DROP",
+	"IEEE80211_DEBUG_EAP",
+	"IEEE80211_DEBUG_FRAG",
+	"IEEE80211_DEBUG_MGMT",
+	"IEEE80211_DEBUG_QOS",
+	"IEEE80211_DEBUG_SCAN",
+	"IEEE80211_DEBUG_WX",
+	"IEEE80211_ERROR",
+	"IEEE80211_INFO",
+	"ieee802154_print_addr",
+	"IF_ABR",
+	"IF_CBR",
+	"IF_ERR",
+	"IF_EVENT",
+	"IF_INIT",
+	"IF_RX",
+	"IF_RXPKT",
+	"IF_TX",
+	"IF_TXPKT",
+	"IF_UBR",
+	"IL_ERR",
+	"IL_INFO",
+	"IL_WARN",
+	"IL_WARN_ONCE",
+	"ima_log_string",
+	"imm_fail",
+	"INF_MSG",
+	"info",
+	"INFO",
+	"inform",
+	"input_dbg",
+	"intc_irqpin_dbg",
+	"intel_pt_log",
+	"intel_pt_log_at",
+	"intel_pt_log_to",
+	"intel_pt_print_info_str",
+	"INTERNAL_DEBMSG",
+	"INTERNAL_ERRMSG",
+	"INTERNAL_INFMSG",
+	"INTERNAL_WRNMSG",
+	"INTPRINTK",
+	"ioapic_debug",
+	"iop_pr_cont",
+	"iop_pr_debug",
+	"IOR_DBG",
+	"ipoib_dbg",
+	"ipr_dbg",
+	"ipr_err",
+	"ipr_hcam_err",
+	"ipr_info",
+	"IPRINTK",
+	"ipr_phys_res_err",
+	"ipr_res_err",
+	"ipr_trace",
+	"ipoib_dbg",
+	"ipoib_dbg_mcast",
+	"ipoib_warn",
+	"IPS_PRINTK",
+	"IP_VS_DBG",
+	"IP_VS_DBG_RL",
+	"IP_VS_ERR_RL",
+	"ip_vs_scheduler_err",
+	"IPW_DEBUG",
+	"IPW_DEBUG_ASSOC",
+	"IPW_DEBUG_DROP",
+	"IPW_DEBUG_ERROR",
+	"IPW_DEBUG_FRAG",
+	"IPW_DEBUG_FW",
+	"IPW_DEBUG_FW_INFO",
+	"IPW_DEBUG_HC",
+	"IPW_DEBUG_INFO",
+	"IPW_DEBUG_IO",
+	"IPW_DEBUG_ISR",
+	"IPW_DEBUG_LED",
+	"IPW_DEBUG_MERGE",
+	"IPW_DEBUG_NOTIF",
+	"IPW_DEBUG_ORD",
+	"IPW_DEBUG_QOS",
+	"IPW_DEBUG_RF_KILL",
+	"IPW_DEBUG_RX",
+	"IPW_DEBUG_SCAN",
+	"IPW_DEBUG_STATS",
+	"IPW_DEBUG_TX",
+	"IPW_DEBUG_WEP",
+	"IPW_DEBUG_WX",
+	"IPW_ERROR",
+	"IPW_WARNING",
+	"ir_dbg",
+	"ir_dprintk",
+	"IR_dprintk",
+	"irqc_dbg",
+	"irq_dbg",
+	"irq_err",
+	"iscsi_conn_printk",
+	"ISCSI_DBG_CONN",
+	"ISCSI_DBG_EH",
+	"ISCSI_DBG_SESSION",
+	"ISCSI_DBG_TCP",
+	"ISCSI_DBG_TRANS_CONN",
+	"ISCSI_DBG_TRANS_SESSION",
+	"ISCSI_SW_TCP_DBG",
+	"iser_dbg",
+	"iser_err",
+	"iser_info",
+	"iser_warn",
+	"isert_dbg",
+	"isert_err",
+	"isert_info",
+	"isert_print_wc",
+	"isert_warn",
+	"isp_dbg",
+	"itd_dbg",
+	"itd_dbg_verbose",
+	"itd_info",
+	"itd_warn",
+	"ite_dbg",
+	"ite_dbg_verbose",
+	"ite_pr",
+	"IVTV_ALSA_ERR",
+	"IVTV_ALSA_INFO",
+	"IVTV_ALSA_WARN",
+	"IVTV_DEBUG_ALSA_INFO",
+	"IVTV_DEBUG_DMA",
+	"IVTV_DEBUG_FILE",
+	"IVTV_DEBUG_HI_DMA",
+	"IVTV_DEBUG_HI_FILE",
+	"IVTV_DEBUG_HI_I2C",
+	"IVTV_DEBUG_HI_IRQ",
+	"IVTV_DEBUG_HI_MB",
+	"IVTV_DEBUG_I2C",
+	"IVTV_DEBUG_INFO",
+	"IVTV_DEBUG_IOCTL",
+	"IVTV_DEBUG_IRQ",
+	"IVTV_DEBUG_MB",
+	"IVTV_DEBUG_WARN",
+	"IVTV_DEBUG_YUV",
+	"IVTV_ERR",
+	"IVTVFB_DEBUG_INFO",
+	"IVTVFB_DEBUG_WARN",
+	"IVTVFB_ERR",
+	"IVTVFB_INFO",
+	"IVTVFB_WARN",
+	"IVTV_INFO",
+	"IVTV_WARN",
+	"IWL_DEBUG_11H",
+	"IWL_DEBUG_ASSOC",
+	"IWL_DEBUG_CALIB",
+	"IWL_DEBUG_COEX",
+	"IWL_DEBUG_DEV",
+	"IWL_DEBUG_DEV_RADIO",
+	"IWL_DEBUG_DROP",
+	"IWL_DEBUG_EEPROM",
+	"IWL_DEBUG_FW",
+	"IWL_DEBUG_HC",
+	"IWL_DEBUG_HT",
+	"IWL_DEBUG_INFO",
+	"IWL_DEBUG_ISR",
+	"IWL_DEBUG_LAR",
+	"IWL_DEBUG_MAC80211",
+	"IWL_DEBUG_POWER",
+	"IWL_DEBUG_QUIET_RFKILL",
+	"IWL_DEBUG_QUOTA",
+	"IWL_DEBUG_RADIO",
+	"IWL_DEBUG_RATE",
+	"IWL_DEBUG_RATE_LIMIT",
+	"IWL_DEBUG_RF_KILL",
+	"IWL_DEBUG_RPM",
+	"IWL_DEBUG_RX",
+	"IWL_DEBUG_SCAN",
+	"IWL_DEBUG_STATS",
+	"IWL_DEBUG_STATS_LIMIT",
+	"IWL_DEBUG_TDLS",
+	"IWL_DEBUG_TE",
+	"IWL_DEBUG_TEMP",
+	"IWL_DEBUG_TX",
+	"IWL_DEBUG_TX_QUEUES",
+	"IWL_DEBUG_TX_REPLY",
+	"IWL_DEBUG_WEP",
+	"IWL_ERR",
+	"IWL_ERR_DEV",
+	"IWL_INFO",
+	"IWL_WARN",
+	"IX25DEBUG",
+	"jbd_debug",
+	"jent_panic",
+	"jffs2_dbg",
+	"JFFS2_DEBUG",
+	"JFFS2_ERROR",
+	"JFFS2_NOTICE",
+	"JFFS2_WARNING",
+	"jfs_err",
+	"jfs_error",
+	"jfs_info",
+	"jfs_warn",
+	"jsm_dbg",
+	"K1212_DEBUG_PRINTK",
+	"K1212_DEBUG_PRINTK_VERBOSE",
+	"kasprintf",
+	"kdb_printf",
+	"kdcore",
+	"kdebug",
+	"KINFO",
+	"kmemleak_stop",
+	"kmemleak_warn",
+	"kputs",
+	"kvasprintf",
+	"kvm_debug",
+	"kvm_debug_ratelimited",
+	"kvm_err",
+	"KVM_EVENT",
+	"kvm_info",
+	"kvm_pr_debug_ratelimited",
+	"kvm_pr_err_ratelimited",
+	"kvm_pr_unimpl",
+	"l2m_debug",
+	"l2tp_dbg",
+	"l2tp_info",
+	"l3_debug",
+	"lapb_dbg",
+	"LCONSOLE_ERROR",
+	"LCONSOLE_ERROR_MSG",
+	"LCONSOLE_INFO",
+	"LCONSOLE_WARN",
+	"LDBG",
+	"ldcdbg",
+	"LDLM_DEBUG",
+	"LDLM_DEBUG_NOLOCK",
+	"LDLM_ERROR",
+	"ldm_crit",
+	"ldm_debug",
+	"ldm_error",
+	"ldm_info",
+	"led_print",
+	"lg_dbg",
+	"lg_debug",
+	"lg_err",
+	"lg_reg",
+	"lg_warn",
+	"libcfs_debug_msg",
+	"LIBFCOE_TRANSPORT_DBG",
+	"LIBFCOE_FIP_DBG",
+	"LIBFCOE_SYSFS_DBG",
+	"LIBIPW_DEBUG_DROP",
+	"LIBIPW_DEBUG_FRAG",
+	"LIBIPW_DEBUG_INFO",
+	"LIBIPW_DEBUG_MGMT",
+	"LIBIPW_DEBUG_QOS",
+	"LIBIPW_DEBUG_SCAN",
+	"LIBIPW_DEBUG_WX",
+	"LIBIPW_ERROR",
+	"link_debug",
+	"link_print",
+	"log",
+	"LOG",
+	"LOG_BLOB",
+	"LOG_DBG",
+	"log_debug",
+	"log_bug",
+	"log_err",
+	"LOG_ERROR",
+	"log_error",
+	"LOG_INFO",
+	"log_info",
+	"LOG_PARSE",
+	"log_print",
+	"LOG_WARN",
+	"log_warn",
+	"mb_debug",
+	"mce_panic",
+	"mcg_debug_group",
+	"mcg_warn",
+	"mcg_warn_group",
+	"mc_printk",
+	"mcsa_dbg",
+	"mei_err",
+	"mei_msg",
+	"merror",
+	"message",
+	"memblock_dbg",
+	"merror",
+	"METHOD_TRACE",
+	"mfc_debug",
+	"mfc_err",
+	"mfc_err_limited",
+	"mfd_fail_new",
+	"mhwmp_dbg",
+	"MG_DBG",
+	"mips_display_message",
+	"mmiotrace_printk",
+	"mlme_dbg",
+	"mlog",
+	"mlog_bug_on_msg",
+	"mlx4_dbg",
+	"mlx4_err",
+	"mlx4_ib_warn",
+	"mlx4_info",
+	"mlx4_warn",
+	"mlx5_core_dbg",
+	"mlx5_core_err",
+	"mlx5_core_info",
+	"mlx5_core_warn",
+	"mlx5_fpga_dbg",
+	"mlx5_fpga_err",
+	"mlx5_fpga_info",
+	"mlx5_fpga_warn",
+	"mlx5_fpga_warn_ratelimited",
+	"mlx5_ib_dbg",
+	"mlx5_ib_err",
+	"mlx5_ib_warn",
+	"mmiotrace_printk",
+	"mpath_dbg",
+	"mpath_dbg",
+	"mprintk",
+	"mps_dbg",
+	"mod_debug",
+	"mod_err",
+	"mpath_dbg",
+	"mpl_dbg",
+	"mprintk",
+	"mpsslog",
+	"msg",
+	"MSG",
+	"MSG_8192C",
+	"MSG_88E",
+	"msync_dbg",
+	"mthca_dbg",
+	"mthca_err",
+	"mthca_warn",
+	"mtk_mdp_dbg",
+	"mtk_mdp_err",
+	"mtk_v4l2_debug",
+	"mtk_v4l2_err",
+	"mtk_vcodec_debug",
+	"mtk_vcodec_err",
+	"MTS_DEBUG",
+	"MTS_ERROR",
+	"mus_dbg",
+	"mv_dprintk",
+	"mv_printk",
+	"mwifiex_dbg",
+	"mxl_dbg",
+	"mxl_debug",
+	"mxl_debug_adv",
+	"mxl_i2c",
+	"mxl_i2c_adv",
+	"mxl_info",
+	"mxl_warn",
+	"mxm_dbg",
+	"mxm_err",
+	"ncp_dbg",
+	"ncp_vdbg",
+	"ND_PRINK",
+	"neigh_dbg",
+	"nes_debug",
+	"NDD_TRACE",
+	"net_crit_ratelimited",
+	"net_dbg_ratelimited",
+	"netdev_alert",
+	"netdev_crit",
+	"netdev_dbg",
+	"netdev_emerg",
+	"netdev_err",
+	"netdev_info",
+	"netdev_notice",
+	"NETDEV_PR_FMT",
+	"netdev_printk",
+	"netdev_vdbg",
+	"netdev_warn",
+	"netdev_WARN",
+	"net_err_ratelimited",
+	"netif_crit",
+	"netif_dbg",
+	"netif_err",
+	"netif_info",
+	"netif_notice",
+	"netif_printk",
+	"netif_vdbg",
+	"netif_warn",
+	"net_info_ratelimited",
+	"net_notice_ratelimited",
+	"net_warn_ratelimited",
+	"nfc_err",
+	"nfc_info",
+	"NFCSIM_DBG",
+	"NFCSIM_ERR",
+	"NFDEBUG",
+	"nfp_err",
+	"nfp_info",
+	"nfp_warn",
+	"nilfs_error",
+	"nilfs_msg",
+	"nmi_debug",
+	"nmi_panic",
+	"nn_dbg",
+	"nn_dp_warn",
+	"nn_err",
+	"nn_info",
+	"nn_warn",
+	"noisy_printk",
+	"non_fatal",
+	"no_printk",
+	"NPRINTK",
+	"np_err",
+	"np_info",
+	"np_notice",
+	"NS_DBG",
+	"NS_ERR",
+	"NS_INFO",
+	"NS_LOG",
+	"NS_WARN",
+	"nsp32_dbg",
+	"nsp32_msg",
+	"nsp_dbg",
+	"nsp_msg",
+	"ntfs_debug",
+	"ntfs_error",
+	"ntfs_warning",
+	"numadbg",
+	"nvdev_error",
+	"nvdev_info",
+	"nvdev_trace",
+	"NV_ERROR",
+	"NV_WARN",
+	"nvif_debug",
+	"nvif_error",
+	"nvif_fatal",
+	"nvif_ioctl",
+	"nvif_trace",
+	"nvkm_debug",
+	"nvkm_error",
+	"nvkm_fatal",
+	"nvkm_info",
+	"nvkm_printk",
+	"nvkm_trace",
+	"nvkm_warn",
+	"nvt_dbg",
+	"nvt_dbg_verbose",
+	"ocb_dbg",
+	"ocfs2_error",
+	"ocfs2_log_dlm_error",
+	"ohci_dbg",
+	"ohci_dbg_sw",
+	"ohci_err",
+	"ohci_notice",
+	"ohci_warn",
+	"OPRINTK",
+	"ORE_DBGMSG",
+	"ORE_DBGMSG2",
+	"ORE_ERR",
+	"OSC_IO_DEBUG",
+	"OSD_DEBUG",
+	"OSD_ERR",
+	"OSDBLK_DEBUG",
+	"OSD_DEBUG",
+	"OSD_ERR",
+	"OSD_INFO",
+	"OSD_SENSE_PRINT1",
+	"OSD_SENSE_PRINT2",
+	"OUTP_DBG",
+	"OUTP_ERR",
+	"oxu_dbg",
+	"oxu_err",
+	"oxu_info",
+	"oxu_vdbg",
+	"p9_debug",
+	"packet_log",
+	"pair_err",
+	"pair_dbg",
+	"pair_err",
+	"panic",
+	"PANIC",
+	"parse_err",
+	"pch_dbg",
+	"pch_err",
+	"pch_pci_dbg",
+	"pch_pci_err",
+	"__pcidebug",
+	"pci_dbg",
+	"pci_err",
+	"pci_info",
+	"pci_note_irq_problem",
+	"pci_notice",
+	"pci_printk",
+	"pci_warn",
+	"pcm_dbg",
+	"pcm_err",
+	"pcr_dbg",
+	"PDBG",
+	"PDEBUG",
+	"pdprintf",
+	"PDPRINTK",
+	"pdtlb_kernel",
+	"pe_err",
+	"pe_info",
+	"pe_warn",
+	"PERR",
+	"perror",
+	"PERROR",
+	"pgd_ERROR",
+	"pgprintk",
+	"phydev_dbg",
+	"phydev_err",
+	"phx_mmu",
+	"phx_warn",
+	"PHYDM_SNPRINTF",
+	"PHY_ERR",
+	"p_info",
+	"pid_dbg_print",
+	"pio_rx_error",
+	"PINFO",
+	"pk_error",
+	"pkt_dbg",
+	"pkt_err",
+	"pkt_info",
+	"pkt_notice",
+	"PKT_ERROR",
+	"PM8001_DISC_DBG",
+	"PM8001_EH_DBG",
+	"PM8001_FAIL_DBG",
+	"PM8001_IO_DBG",
+	"PM8001_MSG_DBG",
+	"pm8001_printk",
+	"pmcraid_err",
+	"pmcraid_info",
+	"pm_dev_dbg",
+	"pm_pr_dbg",
+	"pmd_ERROR",
+	"pmz_debug",
+	"pmz_error",
+	"pmz_info",
+	"pnd2_mc_printk",
+	"pnd2_printk",
+	"pnp_dbg",
+	"pnp_printf",
+	"pnpbios_print_status",
+	"ppa_fail",
+	"ppc4xx_edac_mc_printk",
+	"ppc4xx_edac_printk",
+	"PP_DBG_LOG",
+	"pr",
+	"PR",
+	"pr2",
+	"pr_alert",
+	"pr_alert_once",
+	"pr_alert_ratelimited",
+	"pr_cont",
+	"pr_cont_once",
+	"pr_crit",
+	"pr_crit_once",
+	"pr_crit_ratelimited",
+	"pr_debug",
+	"pr_debug2",
+	"pr_debug3",
+	"pr_debug4",
+	"pr_debug_once",
+	"pr_debug_ratelimited",
+	"pr_define",
+	"pr_devel",
+	"pr_devel_once",
+	"pr_devel_ratelimited",
+	"pr_devinit",
+	"PR_DEVEL",
+	"pr_efi",
+	"pr_efi_err",
+	"pr_emerg",
+	"pr_emerg_once",
+	"pr_emerg_ratelimited",
+	"pr_err",
+	"pr_err_once",
+	"pr_err_ratelimited",
+	"pr_err_with_code",
+	"pr_fmt",
+	"pr_hard",
+	"pr_hardcont",
+	"pr_info",
+	"pr_info_ipaddr",
+	"pr_info_once",
+	"pr_info_ratelimited",
+	"pr_init",
+	"print",
+	"PRINT",
+	"PRINT_ADDR",
+	"PRINT_ATTR",
+	"PRINT_CCK_RATE",
+	"PRINT_CLOCK",
+	"PRINT_CMD",
+	"print_credit_info",
+	"printd",
+	"PRINTD",
+	"PRINTDB",
+	"print_dpcm_info",
+	"print_dbg",
+	"PRINT_DEBUG",
+	"print_err",
+	"PRINT_ERR",
+	"PRINT_FCALL_ERROR",
+	"printf",
+	"PRINTF",
+	"printf_alert",
+	"PRINT_FATAL",
+	"PRINT_FIELD",
+	"printf_crit",
+	"printf_debug",
+	"printf_err",
+	"printf_info",
+	"printf_notice",
+	"printf_warning",
+	"print_info",
+	"PRINT_INFO",
+	"printk",
+	"PRINTK",
+	"PRINTK2",
+	"PRINTK_2",
+	"PRINTK3",
+	"PRINTK_5",
+	"printk_deferred",
+	"printk_deferred_once",
+	"printk_emit",
+	"PRINTK_ERROR",
+	"PRINTKE",
+	"PRINTKI",
+	"printk_once",
+	"printk_ratelimited",
+	"print_lockdep_off",
+	"PRINT_MASKED_VAL",
+	"PRINT_MASKED_VAL_L2",
+	"PRINT_MASKED_VAL_MISC",
+	"PRINT_MASKED_VALP",
+	"printl",
+	"print_message",
+	"print_metric",
+	"print_symbol",
+	"print_temp",
+	"print_testname",
+	"print_track",
+	"print_warn",
+	"PRINT_WARN",
+	"PRINTR",
+	"printv",
+	"pr_notice",
+	"pr_notice_once",
+	"pr_notice_ratelimited",
+	"PROBE_DEBUG",
+	"prom_debug",
+	"prom_panic",
+	"prom_print",
+	"prom_printf",
+	"prom_reboot",
+	"prom_stdout",
+	"prom_warn",
+	"prop_warn",
+	"pr_probe",
+	"pr_stat",
+	"pr_trace",
+	"pr_vdebug",
+	"pr_vlog",
+	"pr_warn",
+	"pr_warning",
+	"pr_warning_once",
+	"pr_warn_once",
+	"pr_warn_ratelimited",
+	"prx",
+	"ps_dbg",
+	"psmouse_dbg",
+	"psmouse_err",
+	"psmouse_info",
+	"psmouse_printk",
+	"psmouse_warn",
+	"puts",
+	"puts_raw",
+	"putstr",
+	"PWARN",
+	"PWC_DEBUG_FLOW",
+	"PWC_DEBUG_IOCTL",
+	"PWC_DEBUG_MEMORY",
+	"PWC_DEBUG_OPEN",
+	"PWC_DEBUG_PROBE",
+	"PWC_DEBUG_SIZE",
+	"PWC_ERROR",
+	"PWC_INFO",
+	"PWC_TRACE",
+	"PWC_WARNING",
+	"Py_FatalError",
+	"qdisc_warn_nonwc",
+	"QDUMP",
+	"QERROR",
+	"QEDF_ERR",
+	"QEDF_INFO",
+	"QEDF_WARN",
+	"QEDI_ERR",
+	"QEDI_INFO",
+	"QEDI_NOTICE",
+	"QEDI_WARN",
+	"qib_dev_err",
+	"qib_devinfo",
+	"qib_dev_porterr",
+	"ql4_printk",
+	"ql_dbg",
+	"ql_log",
+	"quota_error",
+	"qxl_io_log",
+	"raid10_log",
+	"raid1_log",
+	"rbd_warn",
+	"RBRQ_HBUF_ERR",
+	"RCU_LOCKDEP_WARN",
+	"rdev_dbg",
+	"rdev_err",
+	"rdev_info",
+	"rdev_warn",
+	"rds_ib_conn_error",
+	"rdrif_dbg",
+	"rdrif_err",
+	"rdsdebug",
+	"RDBG",
+	"r128_print_dirty",
+	"r_ddprintk",
+	"r_dprintk",
+	"regs__printf",
+	"rdsdebug",
+	"REFCOUNT_WARN",
+	"reiserfs_abort",
+	"reiserfs_error",
+	"reiserfs_info",
+	"reiserfs_panic",
+	"reiserfs_printk",
+	"reiserfs_warning",
+	"report",
+	"RGMII_DBG",
+	"RGMII_DBG2",
+	"riocm_debug",
+	"riocm_error",
+	"riocm_warn",
+	"rl_printf",
+	"rmap_printk",
+	"rmcd_debug",
+	"rmcd_error",
+	"rmcd_warn",
+	"rmi_dbg",
+	"RPRINTK",
+	"RTL_DEBUG",
+	"RT_TRACE",
+	"rt2x00_dbg",
+	"rt2x00_eeprom_dbg",
+	"rt2x00_err",
+	"rt2x00_info",
+	"rt2x00_probe_err",
+	"rt2x00_warn",
+	"RTL_DEBUG",
+	"RPRINT",
+	"RWDEBUG",
+	"rvt_pr_err",
+	"rvt_pr_info",
+	"RXD",
+	"RXPRINTK",
+	"RXS_ERR",
+	"s3c_freq_dbg",
+	"s3c_freq_iodbg",
+	"rmcd_error",
+	"rmcd_warn",
+	"RPRINTK",
+	"RTL_DEBUG",
+	"RT_TRACE",
+	"RWDEBUG",
+	"RXD",
+	"RXPRINTK",
+	"RXS_ERR",
+	"s2255_dev_err",
+	"s3c_freq_dbg",
+	"s3c_freq_iodbg",
+	"S3C_PMDBG",
+	"SAS_DPRINTK",
+	"sas_ata_printk",
+	"sas_printk",
+	"sbridge_mc_printk",
+	"sbridge_printk",
+	"sclp_early_printk",
+	"scrub_print_warning",
+	"sched_numa_warn",
+	"scif_err_debug",
+	"sclp_early_printk",
+	"scmd_printk",
+	"SCM_LOG",
+	"scnprintf",
+	"__sdata_dbg",
+	"__sdata_err",
+	"sdata_err",
+	"__sdata_info",
+	"sdata_info",
+	"SDEBUG",
+	"sdev_printk",
+	"sd_first_printk",
+	"SDMA_DBG",
+	"sd_printk",
+	"se_kernmode_warn",
+	"semantic_error",
+	"SEQ_OPTS_PRINT",
+	"SEQ_OPTS_PUTS",
+	"seq_buf_printf",
+	"seq_printf",
+	"seq_puts",
+	"SEQ_printf",
+	"setup_early_printk",
+	"shost_printk",
+	"sil164_dbg",
+	"sil164_err",
+	"sil164_info",
+	"skx_mc_printk",
+	"skx_printk",
+	"slab_bug",
+	"slab_err",
+	"slab_error",
+	"slab_fix",
+	"slice_dbg",
+	"sm_printk",
+	"SMP_DBG",
+	"smp_debug",
+	"sm_printk",
+	"SMSC_TRACE",
+	"SMSC_WARN",
+	"SMT_PANIC",
+	"snd_iprintf",
+	"snd_printd",
+	"snd_printdd",
+	"snd_printddd",
+	"snd_printk",
+	"SNIC_DBG",
+	"SNIC_DISC_DBG",
+	"SNIC_ERR",
+	"SNIC_HOST_ERR",
+	"SNIC_HOST_INFO",
+	"SNIC_INFO",
+	"SNIC_SCSI_DBG",
+	"snprintf",
+	"sprintf",
+	"SOCK_DEBUG",
+	"sock_warn_obsolete_bsdism",
+	"sprintf",
+	"sprinthx",
+	"sprinthx4",
+	"srm_printk",
+	"sr_printk",
+	"ssb_cont",
+	"ssb_dbg",
+	"ssb_emerg",
+	"ssb_err",
+	"ssb_info",
+	"ssb_notice",
+	"ssb_warn",
+	"SSI_LOG",
+	"SSI_LOG_DEBUG",
+	"SSI_LOG_ERR",
+	"SSI_LOG_INFO",
+	"ssp_dbg",
+	"sta_dbg",
+	"starget_printk",
+	"stk1160_dbg",
+	"stk1160_err",
+	"stk1160_info",
+	"stk1160_warn",
+	"STK_ERROR",
+	"STK_INFO",
+	"st_printk",
+	"str_printf",
+	"svc_printk",
+	"SWARN",
+	"swim3_dbg",
+	"swim3_err",
+	"swim3_info",
+	"swim3_warn",
+	"synth_printf",
+	"tb_ctl_info",
+	"tb_ctl_warn",
+	"tb_ctl_WARN",
+	"tb_err",
+	"tb_info",
+	"tb_port_info",
+	"tb_port_warn",
+	"tb_port_WARN",
+	"tb_sw_info",
+	"tb_sw_info",
+	"tb_sw_warn",
+	"tb_sw_WARN",
+	"tb_tunnel_info",
+	"tb_tunnel_warn",
+	"tb_tunnel_WARN",
+	"tb_warn",
+	"tb_WARN",
+	"tcp_error_log",
+	"tcpm_log",
+	"tda_cal",
+	"tda_dbg",
+	"tda_err",
+	"tda_info",
+	"tda_map",
+	"tda_reg",
+	"tda_warn",
+	"tdls_dbg",
+	"tgt_dbg",
+	"tgt_err",
+	"tgt_info",
+	"tgt_log",
+	"tipc_tlv_sprintf",
+	"TLAN_DBG",
+	"tm6000_err",
+	"tmon_log",
+	"TM_DEBUG",
+	"tomoyo_io_printf",
+	"TP_printk",
+	"TP_printk_btrfs",
+	"tprintf",
+	"TRACE",
+	"TRACE2",
+	"TRACE3",
+	"trace_eeprom",
+	"trace_firmware",
+	"trace_i2c",
+	"trace_printk",
+	"trace_seq_printf",
+	"trace_regcache_sync",
+	"trace_rvt_dbg",
+	"trace_seq_printf",
+	"trace_seq_puts",
+	"trace_snd_soc_jack_irq",
+	"ts_debug",
+	"tsi_debug",
+	"tsi_err",
+	"tsi_info",
+	"TTM_DEBUG",
+	"tty_debug",
+	"tty_debug_hangup",
+	"tty_debug_wait_until_sent",
+	"tty_err",
+	"tty_info_ratelimited",
+	"tty_ldisc_debug",
+	"tty_notice",
+	"tty_warn",
+	"tty_write_message",
+	"tuner_dbg",
+	"tuner_err",
+	"tuner_info",
+	"tuner_warn",
+	"TWDEBUG",
+	"TW_PRINTK",
+	"tx_dbg",
+	"TXPRINTK",
+	"ubi_err",
+	"ubifs_err",
+	"ubifs_errc",
+	"ubifs_msg",
+	"ubifs_warn",
+	"ubi_msg",
+	"ubi_warn",
+	"udbg_printf",
+	"udbg_puts",
+	"udbg_write",
+	"udf_debug",
+	"udf_err",
+	"udf_info",
+	"udf_warn",
+	"udp_error_log",
+	"udplite_error_log",
+	"uea_dbg",
+	"uea_err",
+	"uea_info",
+	"uea_vdbg",
+	"uea_warn",
+	"ufs_error",
+	"ufs_panic",
+	"ufs_warning",
+	"ugeth_vdbg",
+	"ultra_iprintf",
+	"unaligned_panic",
+	"unaligned_printk",
+	"unpoison_pr_info",
+	"unw_debug",
+	"uprobe_warn",
+	"urb_dbg",
+	"URB_DBG",
+	"URB_DPRINT",
+	"usb_audio_dbg",
+	"usb_audio_err",
+	"usb_audio_info",
+	"usb_dbg",
+	"usb_err",
+	"usb_info",
+	"usb_warn",
+	"usbip_dbg_eh",
+	"usbip_dbg_stub_rx",
+	"usbip_dbg_stub_tx",
+	"usbip_dbg_vhci_hc",
+	"usbip_dbg_vhci_rh",
+	"usbip_dbg_vhci_rx",
+	"usbip_dbg_vhci_sysfs",
+	"usbip_dbg_vhci_tx",
+	"usbip_dbg_xmit",
+	"usb_stor_dbg",
+	"user_log_dlm_error",
+	"usnic_dbg",
+	"usnic_err",
+	"usnic_info",
+	"uvc_printk",
+	"uvc_trace",
+	"v1printk",
+	"v2printk",
+	"v4l2_dbg",
+	"v4l2_err",
+	"v4l2_info",
+	"v4l2_warn",
+	"v4l_dbg",
+	"v4l_err",
+	"v4l_info",
+	"v4l_warn",
+	"var_printf",
+	"vbi_dbg",
+	"vbg_err",
+	"v_dbg",
+	"vbprintf",
+	"vchiq_log_error",
+	"vchiq_log_info",
+	"vchiq_log_trace",
+	"vchiq_log_warning",
+	"vchiq_loud_error",
+	"vcpu_debug",
+	"vcpu_debug_ratelimited",
+	"vcpu_err",
+	"VCPU_EVENT",
+	"VCPU_TP_PRINTK",
+	"vcpu_unimpl",
+	"vdbg_printk",
+	"VDBG",
+	"VDEB",
+	"VDEBUG",
+	"vdev_err",
+	"vdev_neterr",
+	"vdev_netwarn",
+	"vdev_warn",
+	"vdprintf",
+	"VDBG",
+	"VDEB",
+	"v_err",
+	"verbose",
+	"verbose_debug",
+	"verbose_printk",
+	"vfprintf",
+	"vfp_panic",
+	"vgaarb_dbg",
+	"vgaarb_err",
+	"vgaarb_info",
+	"video_dbg",
+	"vin_dbg",
+	"vin_err",
+	"viodbg",
+	"VLDBG",
+	"VMM_DEBUG",
+	"vmci_ioctl_err",
+	"vpe_dbg",
+	"vpe_err",
+	"vpfe_dbg",
+	"vpfe_err",
+	"vpfe_info",
+	"vpif_dbg",
+	"vpif_err",
+	"vpr_info",
+	"vpr_info_dq",
+	"vprint",
+	"VPRINTK",
+	"vprintf",
+	"vprintk",
+	"VPRINTK",
+	"vprintk_emit",
+	"vq_err",
+	"vsnprintf",
+	"vsprintf",
+	"v_warn",
+	"wait_err",
+	"wait_warn",
+	"warn",
+	"WARN",
+	"WARN_FUNC",
+	"warning",
+	"WARNING",
+	"warn_invalid_dmar",
+	"WARN_ON",
+	"WARN_ONCE",
+	"WARN_ON_ONCE",
+	"__WARN_printf",
+	"WARN_RATELIMIT",
+	"warnx",
+	"WASM",
+	"wcn36xx_dbg",
+	"wcn36xx_err",
+	"wcn36xx_info",
+	"wcn36xx_warn",
+	"whc_hw_error",
+	"wil_dbg_fw",
+	"wil_dbg_irq",
+	"wil_dbg_misc",
+	"wil_dbg_pm",
+	"wil_dbg_ratelimited",
+	"wil_dbg_txrx",
+	"wil_dbg_wmi",
+	"wil_err",
+	"wil_err_fw",
+	"__wil_err_ratelimited",
+	"wil_info",
+	"wiphy_dbg",
+	"wiphy_debug",
+	"wiphy_err",
+	"wiphy_info",
+	"wiphy_notice",
+	"wiphy_warn",
+	"wl1251_debug",
+	"wl1251_error",
+	"wl1251_info",
+	"wl1251_notice",
+	"wl1251_warning",
+	"wl1271_debug",
+	"wl1271_error",
+	"wl1271_info",
+	"wl1271_notice",
+	"wl1271_warning",
+	"WRN_MSG",
+	"xasprintf",
+	"xdi_dbg_xlog",
+	"xenbus_dev_error",
+	"xenbus_dev_fatal",
+	"xenbus_printf",
+	"xen_raw_console_write",
+	"xen_raw_printk",
+	"xfs_alert",
+	"xfs_crit",
+	"xfs_info",
+	"xfs_debug",
+	"xfs_emerg",
+	"xfs_notice",
+	"xfs_warn",
+	"XFS_CORRUPTION_ERROR",
+	"XFS_ERROR_REPORT",
+	"xhci_dbg",
+	"xhci_dbg_trace",
+	"xhci_err",
+	"xhci_info",
+	"xhci_warn",
+	"XICS_DBG",
+	"xmon_printf",
+	"XPRINTK",
+	"XXDEBUG",
+	"YYFPRINTF",
+	"zconf_error",
+	"z_error",
+	"zip_dbg",
+	"zip_err",
+	"zip_msg",
+	"ZMII_DBG",
+	"ZMII_DBG2",
+	"zpa2326_dbg",
+	"zpa2326_err",
+	"zpa2326_warn",
+	"zpci_err",
+	"zswap_pool_debug",
+};
+
+typedef struct {
+	const char *name;	/* printk like function name */
+	size_t len;		/* length of name */
+	uint32_t hash;		/* word_hash() of name */
+} name_t;
+
+/*
+ *  FNV-1a hash of a word, must match word_hash() in kernelscan.c
+ */
+static uint32_t word_hash(const char *str, size_t len)
+{
+	uint32_t hash = 2166136261U;
+
+	while (len--)
+		hash = (hash ^ (uint8_t)*str++) * 16777619U;
+
+	return hash;
+}
+
+/*
+ *  Slot for a hash given its bucket's displacement, must
+ *  match printk_hash_slot() in kernelscan.c
+ */
+static uint32_t printk_hash_slot(uint32_t hash, const uint32_t disp, const uint32_t n)
+{
+	hash += disp * 0x9e3779b9U;
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bU;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35U;
+	hash ^= hash >> 16;
+
+	return (uint32_t)(((uint64_t)hash * n) >> 32);
+}
+
+/*
+ *  Sort format specifiers longest first so that strip_format()
+ *  matches the longest one that fits
+ */
+static int format_cmp(const void *p1, const void *p2)
+{
+	const char *f1 = *(const char *const *)p1;
+	const char *f2 = *(const char *const *)p2;
+	const size_t l1 = strlen(f1);
+	const size_t l2 = strlen(f2);
+
+	if (l1 < l2)
+		return 1;
+	if (l1 > l2)
+		return -1;
+	return strcmp(f1, f2);
+}
+
+static int name_cmp(const void *p1, const void *p2)
+{
+	const name_t *n1 = (const name_t *)p1;
+	const name_t *n2 = (const name_t *)p2;
+
+	return strcmp(n1->name, n2->name);
+}
+
+/*
+ *  Buckets are placed largest first as they are the
+ *  hardest to fit while the table is still mostly empty
+ */
+static uint32_t *bucket_sizes;
+
+static int bucket_cmp(const void *p1, const void *p2)
+{
+	const uint32_t b1 = *(const uint32_t *)p1;
+	const uint32_t b2 = *(const uint32_t *)p2;
+
+	if (bucket_sizes[b1] != bucket_sizes[b2])
+		return bucket_sizes[b1] < bucket_sizes[b2] ? 1 : -1;
+	return b1 < b2 ? -1 : (b1 > b2);
+}
+
+/*
+ *  Find a displacement for every bucket so that all the names
+ *  hash to distinct slots of a table with exactly n slots,
+ *  fills in slots[] with the index of the name in each slot
+ */
+static int printk_hash_build(
+	const name_t *names,
+	const uint32_t n,
+	uint16_t *disp,
+	uint32_t *slots)
+{
+	uint32_t sizes[PRINTK_HASH_BUCKETS], order[PRINTK_HASH_BUCKETS];
+	uint32_t members[PRINTK_HASH_BUCKETS][16];
+	uint32_t try[16];
+	bool *used;
+	uint32_t i;
+
+	used = calloc(n, sizeof(*used));
+	if (!used) {
+		fprintf(stderr, "Out of memory performing an allocation\n");
+		return -1;
+	}
+	memset(sizes, 0, sizeof(sizes));
+	for (i = 0; i < n; i++) {
+		const uint32_t b = names[i].hash >> (32 - PRINTK_HASH_BITS);
+
+		if (sizes[b] >= SIZEOF_ARRAY(members[0])) {
+			fprintf(stderr, "Too many printk names in perfect hash bucket %" PRIu32 "\n", b);
+			free(used);
+			return -1;
+		}
+		members[b][sizes[b]++] = i;
+	}
+	for (i = 0; i < PRINTK_HASH_BUCKETS; i++)
+		order[i] = i;
+	bucket_sizes = sizes;
+	qsort(order, PRINTK_HASH_BUCKETS, sizeof(order[0]), bucket_cmp);
+
+	for (i = 0; i < PRINTK_HASH_BUCKETS; i++) {
+		const uint32_t b = order[i];
+		uint32_t d, j, k;
+
+		disp[b] = 0;
+		if (!sizes[b])
+			continue;
+		for (d = 0; d < PRINTK_HASH_TRIES; d++) {
+			for (j = 0; j < sizes[b]; j++) {
+				try[j] = printk_hash_slot(names[members[b][j]].hash, d, n);
+				if (used[try[j]])
+					break;
+				for (k = 0; k < j; k++)
+					if (try[k] == try[j])
+						break;
+				if (k < j)
+					break;
+			}
+			if (j == sizes[b])
+				break;
+		}
+		if (d == PRINTK_HASH_TRIES) {
+			fprintf(stderr, "Cannot find a perfect hash displacement for bucket %" PRIu32 "\n", b);
+			free(used);
+			return -1;
+		}
+		disp[b] = d;
+		for (j = 0; j < sizes[b]; j++) {
+			used[try[j]] = true;
+			slots[try[j]] = members[b][j];
+		}
+	}
+	free(used);
+
+	return 0;
+}
+
+static int word_cmp(const void *p1, const void *p2)
+{
+	return strcmp(*(const char *const *)p1, *(const char *const *)p2);
+}
+
+/*
+ *  Emit the printk like function names made of letters only,
+ *  lower cased and sorted.  These are the only names a word
+ *  can be, the spelling checker skips them ignoring case
+ */
+static int printk_words(const name_t *names, const uint32_t n)
+{
+	static char *words[SIZEOF_ARRAY(printks)];
+	uint32_t i, j, w, u;
+
+	for (w = 0, i = 0; i < n; i++) {
+		for (j = 0; j < names[i].len; j++)
+			if (!isalpha((unsigned char)names[i].name[j]))
+				break;
+		if (j < names[i].len)
+			continue;
+		words[w] = strdup(names[i].name);
+		if (!words[w]) {
+			fprintf(stderr, "Out of memory performing an allocation\n");
+			return -1;
+		}
+		for (j = 0; j < names[i].len; j++)
+			words[w][j] = tolower((unsigned char)words[w][j]);
+		w++;
+	}
+	qsort(words, w, sizeof(words[0]), word_cmp);
+	for (u = 0, i = 0; i < w; i++) {
+		if (u && !strcmp(words[u - 1], words[i])) {
+			free(words[i]);
+			continue;
+		}
+		words[u++] = words[i];
+	}
+
+	printf("#define PRINTK_WORDS_SIZE\t(%" PRIu32 ")\n\n", u);
+	printf("/*\n *  printk like function names of letters only,\n"
+	       " *  lower cased and sorted\n */\n");
+	printf("static const char *const printk_words[PRINTK_WORDS_SIZE] = {\n");
+	for (i = 0; i < u; i++) {
+		printf("\t\"%s\",\n", words[i]);
+		free(words[i]);
+	}
+	printf("};\n");
+
+	return 0;
+}
+
+/*
+ *  Emit the printk like function name tables, names are
+ *  matched exactly so duplicates are dropped
+ */
+static int printk_tables(void)
+{
+	static name_t names[SIZEOF_ARRAY(printks)];
+	static uint32_t slots[SIZEOF_ARRAY(printks)];
+	uint16_t disp[PRINTK_HASH_BUCKETS];
+	uint64_t lengths = 0, bigrams[256];
+	uint32_t i, n;
+
+	for (i = 0; i < SIZEOF_ARRAY(printks); i++) {
+		names[i].name = printks[i];
+		names[i].len = strlen(printks[i]);
+		names[i].hash = word_hash(printks[i], names[i].len);
+	}
+	qsort(names, SIZEOF_ARRAY(printks), sizeof(names[0]), name_cmp);
+	for (n = 0, i = 0; i < SIZEOF_ARRAY(printks); i++) {
+		if (n && !strcmp(names[n - 1].name, names[i].name))
+			continue;
+		names[n++] = names[i];
+	}
+
+	memset(bigrams, 0, sizeof(bigrams));
+	for (i = 0; i < n; i++) {
+		if (names[i].len >= 64) {
+			fprintf(stderr, "printk name %s is too long\n", names[i].name);
+			return -1;
+		}
+		lengths |= 1ULL << names[i].len;
+		if (names[i].len > 1)
+			bigrams[(uint8_t)names[i].name[0]] |= 1ULL << (names[i].name[1] & 63);
+	}
+	if (printk_hash_build(names, n, disp, slots) < 0)
+		return -1;
+
+	printf("#define PRINTK_HASH_SIZE\t(%" PRIu32 ")\n", n);
+	printf("#define PRINTK_HASH_BITS\t(%d)\n\n", PRINTK_HASH_BITS);
+
+	printf("/*\n *  lengths of printk like function names\n */\n");
+	printf("static const uint64_t printk_lengths = 0x%016" PRIx64 "ULL;\n\n", lengths);
+
+	printf("/*\n *  second characters (modulo 64) of the printk like\n"
+	       " *  function names, by first character\n */\n");
+	printf("static const uint64_t printk_bigrams[256] ALIGNED(64) = {\n");
+	for (i = 0; i < 256; i++)
+		printf("%s0x%016" PRIx64 "ULL,%s", (i & 3) ? " " : "\t",
+			bigrams[i], ((i & 3) == 3) ? "\n" : "");
+	printf("};\n\n");
+
+	printf("/*\n *  perfect hash displacements, by bucket\n */\n");
+	printf("static const uint16_t printk_hash_disp[%u] ALIGNED(64) = {\n", PRINTK_HASH_BUCKETS);
+	for (i = 0; i < PRINTK_HASH_BUCKETS; i++)
+		printf("%s%5u,%s", (i & 7) ? " " : "\t",
+			disp[i], ((i & 7) == 7) ? "\n" : "");
+	printf("};\n\n");
+
+	printf("/*\n *  printk like function names, by perfect hash slot\n */\n");
+	printf("static const printk_name_t printk_names[PRINTK_HASH_SIZE] = {\n");
+	for (i = 0; i < n; i++)
+		printf("\t{ \"%s\", %zu },\n", names[slots[i]].name, names[slots[i]].len);
+	printf("};\n\n");
+
+	return printk_words(names, n);
+}
+
+/*
+ *  Emit a 256 entry table indexed by character
+ */
+static void char_table(
+	const char *decl,
+	const char *comment,
+	const char *const values[256])
+{
+	size_t i;
+
+	printf("/*\n *  %s\n */\n", comment);
+	printf("static const %s[256] ALIGNED(64) = {\n", decl);
+	for (i = 0; i < 256; i++)
+		printf("%s%s,%s", (i & 7) ? " " : "\t", values[i],
+			((i & 7) == 7) ? "\n" : "");
+	printf("};\n\n");
+}
+
+/*
+ *  Emit the character class tables
+ */
+static void char_tables(void)
+{
+	static const char *const digits[] = {
+		"0", "1", "2", "3", "4", "5", "6", "7", "8", "9",
+		"10", "11", "12", "13", "14", "15", "16", "17", "18", "19",
+		"20", "21", "22", "23", "24", "25", "26",
+	};
+	const char *values[256];
+	size_t i;
+
+	for (i = 0; i < 256; i++)
+		values[i] = ((i == ' ') || (i == '\t')) ? "false" : "true";
+	char_table("bool is_not_whitespace", "characters that are not spaces or tabs", values);
+
+	for (i = 0; i < 256; i++)
+		values[i] = (isalnum(i) || (i == '_')) ? "false" : "true";
+	char_table("bool is_not_identifier", "characters that can't be in an identifier", values);
+
+	for (i = 0; i < 256; i++) {
+		if (isalnum(i) || (i == '_'))
+			values[i] = "SCAN_IDENTIFIER";
+		else
+			values[i] = "0";
+	}
+	values['"'] = "SCAN_QUOTE";
+	values['\''] = "SCAN_APOSTROPHE";
+	values['/'] = "SCAN_SLASH";
+	values['*'] = "SCAN_STAR";
+	values['#'] = "SCAN_HASH";
+	values['\n'] = "SCAN_NEWLINE";
+	values['\\'] = "SCAN_BACKSLASH";
+	values['{'] = "SCAN_BRACE_OPENED";
+	values['}'] = "SCAN_BRACE_CLOSED";
+	values[';'] = "SCAN_SEMICOLON";
+	char_table("uint16_t scan_class", "structural indexer character classes", values);
+
+	for (i = 0; i < 256; i++) {
+		if (islower(i))
+			values[i] = digits[i - 'a'];
+		else if (isupper(i))
+			values[i] = digits[i - 'A'];
+		else if (isdigit(i) || (i == '_'))
+			values[i] = digits[26];
+		else
+			values[i] = "BAD_MAPPING";
+	}
+	char_table("uint8_t mapping", "characters to DAWG labels, a..z -> 0..25 and _/0..9 as 26", values);
+}
+
+/*
+ *  Emit the printk format specifiers, longest first, and a
+ *  DFA that matches what follows a '%' in one pass: an
+ *  optional '-', any digits and '.'s, then the longest
+ *  specifier. State 0 is dead, FORMAT_START is the start
+ *  state and FORMAT_START + 1 follows the flags, width and
+ *  precision. Both of those accept, so the flags, width and
+ *  precision are consumed even when no specifier follows,
+ *  the remaining states are a trie of the specifiers.
+ *  Characters are reduced to classes of characters with
+ *  identical transitions to keep the table small.
+ */
+static int format_tables(void)
+{
+	static int next[FORMAT_STATES_MAX][256];
+	static uint8_t accept[FORMAT_STATES_MAX];
+	uint8_t class[256], rep[256];
+	int i, c, n_states = 3, n_classes = 0;
+
+	/* trie of the specifiers, rooted in state 2 */
+	memset(next, 0, sizeof(next));
+	memset(accept, 0, sizeof(accept));
+	for (i = 0; i < (int)SIZEOF_ARRAY(formats); i++) {
+		const unsigned char *ptr;
+		int state = 2;
+
+		for (ptr = (const unsigned char *)formats[i]; *ptr; ptr++) {
+			if (!next[state][*ptr]) {
+				if (n_states >= FORMAT_STATES_MAX) {
+					fprintf(stderr, "Too many format DFA states\n");
+					return -1;
+				}
+				next[state][*ptr] = n_states++;
+			}
+			state = next[state][*ptr];
+		}
+		accept[state] = i + 1;
+	}
+
+	/* the start and flags states move to the trie root's children */
+	for (c = 0; c < 256; c++) {
+		const bool prefix = isdigit(c) || (c == '.');
+
+		if (next[2][c] && (prefix || (c == '-'))) {
+			fprintf(stderr, "Format specifier starts with flag character %c\n", c);
+			return -1;
+		}
+		next[1][c] = ((c == '-') || prefix) ? 2 : next[2][c];
+		next[2][c] = prefix ? 2 : next[2][c];
+	}
+	accept[FORMAT_START] = FORMAT_PREFIX;
+	accept[FORMAT_START + 1] = FORMAT_PREFIX;
+
+	/* characters with the same transitions share a class */
+	for (c = 0; c < 256; c++) {
+		int k;
+
+		for (k = 0; k < n_classes; k++) {
+			for (i = 0; i < n_states; i++)
+				if (next[i][c] != next[i][rep[k]])
+					break;
+			if (i == n_states)
+				break;
+		}
+		if (k == n_classes)
+			rep[n_classes++] = c;
+		class[c] = k;
+	}
+
+	printf("#define FORMAT_STATES\t\t(%d)\n", n_states);
+	printf("#define FORMAT_CLASSES\t\t(%d)\n", n_classes);
+	printf("#define FORMAT_START\t\t(%d)\n", FORMAT_START);
+	printf("#define FORMAT_PREFIX\t\t(%d)\n\n", FORMAT_PREFIX);
+
+	printf("/*\n *  format DFA character classes\n */\n");
+	printf("static const uint8_t format_class[256] ALIGNED(64) = {\n");
+	for (c = 0; c < 256; c++)
+		printf("%s%3d,%s", (c & 15) ? " " : "\t", class[c], ((c & 15) == 15) ? "\n" : "");
+	printf("};\n\n");
+
+	printf("/*\n *  format DFA transitions, by state and character class\n */\n");
+	printf("static const uint8_t format_next[FORMAT_STATES][FORMAT_CLASSES] ALIGNED(64) = {\n");
+	for (i = 0; i < n_states; i++) {
+		printf("\t{");
+		for (c = 0; c < n_classes; c++)
+			printf("%s%3d", c ? ", " : " ", next[i][rep[c]]);
+		printf(" },\n");
+	}
+	printf("};\n\n");
+
+	printf("/*\n *  format DFA accepting states, kernelscan-formats.h formats[] index + 1,\n"
+	       " *  FORMAT_PREFIX after just flags, width and precision\n */\n");
+	printf("static const uint8_t format_accept[FORMAT_STATES] ALIGNED(64) = {\n");
+	for (i = 0; i < n_states; i++)
+		printf("%s%3d,%s", (i & 15) ? " " : "\t", accept[i],
+			(((i & 15) == 15) || (i == n_states - 1)) ? "\n" : "");
+	printf("};\n\n");
+
+	return 0;
+}
+
+/*
+ *  Emit the format specifiers longest first, the order
+ *  of the format DFA's accepting states
+ */
+static void format_list(void)
+{
+	size_t i;
+
+	printf("/*\n *  printk format string table items\n */\n");
+	printf("typedef struct {\n");
+	printf("\tconst char *format;\t/* printk format string */\n");
+	printf("\tsize_t len;\t\t/* length of format string */\n");
+	printf("} format_t;\n\n");
+
+	printf("/*\n *  Kernel printk format specifiers, longest first\n */\n");
+	printf("static const format_t formats[] = {\n");
+	for (i = 0; i < SIZEOF_ARRAY(formats); i++)
+		printf("\t{ \"%s\", %zu },\n", formats[i], strlen(formats[i]));
+	printf("};\n");
+}
+
+/*
+ *  Emit the types and macros the tables need, so the
+ *  header stands on its own
+ */
+static void table_types(void)
+{
+	printf("#ifndef ALIGNED\n");
+	printf("#define ALIGNED(a)\t__attribute__((aligned(a)))\n");
+	printf("#endif\n\n");
+
+	printf("#define BAD_MAPPING\t\t(0x%x)\t/* not a dictionary character */\n\n", BAD_MAPPING);
+
+	printf("/*\n *  Character class bits for the structural indexer\n */\n");
+	printf("typedef enum {\n");
+	printf("\tSCAN_IDENTIFIER\t\t= 0x001,\t/* a-z, A-Z, 0-9, _ */\n");
+	printf("\tSCAN_QUOTE\t\t= 0x002,\t/* \" */\n");
+	printf("\tSCAN_APOSTROPHE\t\t= 0x004,\t/* ' */\n");
+	printf("\tSCAN_SLASH\t\t= 0x008,\t/* / */\n");
+	printf("\tSCAN_STAR\t\t= 0x010,\t/* * */\n");
+	printf("\tSCAN_HASH\t\t= 0x020,\t/* # C pre-processor */\n");
+	printf("\tSCAN_NEWLINE\t\t= 0x040,\t/* \\n */\n");
+	printf("\tSCAN_BACKSLASH\t\t= 0x080,\t/* \\\\ */\n");
+	printf("\tSCAN_BRACE_OPENED\t= 0x100,\t/* { */\n");
+	printf("\tSCAN_BRACE_CLOSED\t= 0x200,\t/* } */\n");
+	printf("\tSCAN_SEMICOLON\t\t= 0x400,\t/* ; */\n");
+	printf("} scan_class_t;\n\n");
+
+	printf("/*\n *  printk like function name, in the perfect hash table\n */\n");
+	printf("typedef struct {\n");
+	printf("\tconst char *name;\t/* function name */\n");
+	printf("\tsize_t len;\t\t/* length of name */\n");
+	printf("} printk_name_t;\n\n");
+}
+
+int main(int argc, char **argv)
+{
+	const bool list = (argc > 1) && !strcmp(argv[1], "formats");
+
+	qsort(formats, SIZEOF_ARRAY(formats), sizeof(formats[0]), format_cmp);
+
+	printf("/*\n *  Generated by mktables, do not edit\n */\n");
+	printf("#include <stddef.h>\n");
+	printf("#include <stdint.h>\n\n");
+	if (list) {
+		format_list();
+		exit(EXIT_SUCCESS);
+	}
+	table_types();
+	char_tables();
+	if (format_tables() < 0)
+		exit(EXIT_FAILURE);
+	if (printk_tables() < 0)
+		exit(EXIT_FAILURE);
+
+	exit(EXIT_SUCCESS);
+}